@@ -0,0 +1,136 @@
+#ifndef NOS3_ACTUATORDATA_HPP
+#define NOS3_ACTUATORDATA_HPP
+
+/*
+** Includes
+*/
+#include <blackboard_data.hpp>
+
+/*
+** Defines
+*/
+#define ACTUATOR_MAGIC           0x41434F4E  // "NOCA", NOS3 commanded actuators
+#define ACTUATOR_VERSION         1
+#define ACTUATOR_MAX_WHEELS      4
+#define ACTUATOR_MAX_MTBS        3
+#define ACTUATOR_MAX_THRUSTERS   16
+
+/*
+** Namespace
+*/
+namespace Nos3
+{
+    /// \brief The kinds of actuator commanded through the actuator segment
+    enum ActuatorType {
+        ACTUATOR_WHEEL,     // command is the wheel torque, Nm
+        ACTUATOR_MTB,       // command is the magnetorquer dipole, A m^2
+        ACTUATOR_THRUSTER   // command is the thruster pulse width, s
+    };
+
+    struct ActuatorCommand {
+        double AbsTime;     // time the command was written for, seconds since J2000
+        double Command;
+    };
+
+    /** \brief The command of one actuator, versioned by a seqlock like a BlackboardSlot.
+     *
+     *  Each actuator has one writer (the hardware model of that actuator), so several models can command one
+     *  spacecraft without sharing a lock.  Channels are cache line aligned so they do not false share.
+     */
+    struct alignas(64) ActuatorChannel {
+        ActuatorCommand       data;
+        std::atomic<uint32_t> sequence;
+    };
+
+    /** \brief The actuator commands of one spacecraft, the mirror of its BlackboardSlot, written by the hardware models and read by 42.
+     *
+     *  generation advances with every command written to any channel, so the reader can skip a step when no
+     *  actuator was commanded.
+     */
+    struct alignas(64) ActuatorSlot {
+        std::atomic<uint32_t> generation;
+        alignas(64) ActuatorChannel wheels[ACTUATOR_MAX_WHEELS];
+        ActuatorChannel mtbs[ACTUATOR_MAX_MTBS];
+        ActuatorChannel thrusters[ACTUATOR_MAX_THRUSTERS];
+    };
+
+    /** \brief The header of an actuator segment, which is followed by slot_count ActuatorSlots.
+     *
+     *  Whoever claims the zeroed magic first writes the header, magic last; everyone else waits for the magic and
+     *  checks the header (see actuator_attach and blackboard_claim_header).
+     */
+    struct alignas(64) ActuatorSegmentHeader {
+        std::atomic<uint32_t> magic;  // ACTUATOR_MAGIC once the rest of the header is written
+        uint32_t version;             // ACTUATOR_VERSION
+        uint32_t slot_count;
+        uint32_t slot_size;           // sizeof(ActuatorSlot), to catch writers built with another layout
+    };
+
+    /// \brief Returns the bytes of an actuator segment of slot_count slots
+    inline size_t actuator_segment_size(uint32_t slot_count)
+    {
+        return sizeof(ActuatorSegmentHeader) + slot_count*sizeof(ActuatorSlot);
+    }
+
+    /// \brief Returns a slot of an actuator segment
+    inline ActuatorSlot* actuator_slot(ActuatorSegmentHeader* header, uint32_t index)
+    {
+        return reinterpret_cast<ActuatorSlot *>(header + 1) + index;
+    }
+
+    /** \brief Writes the header of a new (zeroed) actuator segment, or checks the header of an existing one.
+     *
+     *  @param header      The header at the start of the mapped segment
+     *  @param slot_count  The slots the segment is created with; an existing segment may have more
+     *  @return            false if the segment was made with a different layout or has fewer slots, or its header was never finished
+     */
+    inline bool actuator_attach(ActuatorSegmentHeader* header, uint32_t slot_count)
+    {
+        if (blackboard_claim_header(header->magic)) {
+            header->version = ACTUATOR_VERSION;
+            header->slot_count = slot_count;
+            header->slot_size = sizeof(ActuatorSlot);
+            header->magic.store(ACTUATOR_MAGIC, std::memory_order_release);
+        }
+        return header->magic.load(std::memory_order_acquire) == ACTUATOR_MAGIC && header->version == ACTUATOR_VERSION && header->slot_size == sizeof(ActuatorSlot) && header->slot_count >= slot_count;
+    }
+
+    /// \brief Returns a channel of a slot, or NULL if the slot has no such actuator
+    inline ActuatorChannel* actuator_channel(ActuatorSlot& slot, ActuatorType type, uint32_t index)
+    {
+        switch (type) {
+        case ACTUATOR_WHEEL:    return index < ACTUATOR_MAX_WHEELS ? &slot.wheels[index] : NULL;
+        case ACTUATOR_MTB:      return index < ACTUATOR_MAX_MTBS ? &slot.mtbs[index] : NULL;
+        case ACTUATOR_THRUSTER: return index < ACTUATOR_MAX_THRUSTERS ? &slot.thrusters[index] : NULL;
+        }
+        return NULL;
+    }
+
+    /// \brief Writes the command of an actuator; there must be one writer per channel
+    inline void actuator_write(ActuatorSlot& slot, ActuatorChannel& channel, const ActuatorCommand& command)
+    {
+        blackboard_seqlock_begin(channel.sequence);
+        memcpy(&channel.data, &command, sizeof(command));
+        blackboard_seqlock_end(channel.sequence);
+        slot.generation.fetch_add(1, std::memory_order_release);
+    }
+
+    /** \brief Copies a consistent command of an actuator, retrying only while its writer is updating it.
+     *
+     *  @param channel  The channel of the actuator
+     *  @param command  The copy of the command
+     *  @return         The (even) sequence of the copy, 0 if the actuator has never been commanded
+     */
+    inline uint32_t actuator_read(const ActuatorChannel& channel, ActuatorCommand& command)
+    {
+        return blackboard_seqlock_read(channel.sequence, &command, &channel.data, sizeof(command));
+    }
+
+    /// \brief Returns the generation of the actuator commands of a slot, the number of commands written so far
+    inline uint32_t actuator_generation(const ActuatorSlot& slot)
+    {
+        return slot.generation.load(std::memory_order_acquire);
+    }
+}
+
+#endif
@@ -4,11 +4,34 @@
 /*
 ** Includes
 */
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <boost/thread.hpp>
 
 /*
 ** Defines
 */
+#define BLACKBOARD_SPINS_BEFORE_YIELD 64
+#define BLACKBOARD_MAGIC              0x42424F4E  // "NOBB"
+#define BLACKBOARD_INITIALIZING       0xFFFFFFFF  // segment header magic while its creator writes the rest of the header
+#define BLACKBOARD_INIT_WAIT_MS       1000        // how long to wait for another process to finish writing a header
+#define BLACKBOARD_VERSION            1
+#define BLACKBOARD_CACHE_LINE         64
+#define BLACKBOARD_MAX_RANGES         8
 
 /*
 ** Namespace
@@ -37,6 +60,418 @@ namespace Nos3
         double AccelAcc[3];
         double WhlH[3];
     };
+
+    /// \brief The field groups of BlackboardData, the bits of a BlackboardFieldMask
+    enum BlackboardField {
+        BLACKBOARD_SVB, BLACKBOARD_BVB, BLACKBOARD_HVB, BLACKBOARD_GYRO_RATE, BLACKBOARD_CSS_VALID, BLACKBOARD_CSS_ILLUM,
+        BLACKBOARD_FSS_VALID, BLACKBOARD_FSS_SUN_ANG, BLACKBOARD_ST_VALID, BLACKBOARD_ST_QN, BLACKBOARD_ABS_TIME, BLACKBOARD_GPS_WEEK,
+        BLACKBOARD_GPS_SEC, BLACKBOARD_GPS_FRAC_SEC, BLACKBOARD_GPS_POS_N, BLACKBOARD_GPS_VEL_N, BLACKBOARD_GPS_POS_W, BLACKBOARD_GPS_VEL_W,
+        BLACKBOARD_ACCEL_ACC, BLACKBOARD_WHL_H, BLACKBOARD_FIELD_COUNT
+    };
+
+    /// \brief The name (as in BlackboardData), offset, and size of a field group
+    struct BlackboardFieldInfo {
+        const char *name;
+        size_t offset;
+        size_t size;
+    };
+
+#define BLACKBOARD_FIELD_INFO(name) {#name, offsetof(BlackboardData, name), sizeof(BlackboardData::name)}
+    /// \brief The field groups of BlackboardData, indexed by BlackboardField
+    inline const BlackboardFieldInfo BLACKBOARD_FIELDS[BLACKBOARD_FIELD_COUNT] = {
+        BLACKBOARD_FIELD_INFO(svb), BLACKBOARD_FIELD_INFO(bvb), BLACKBOARD_FIELD_INFO(Hvb), BLACKBOARD_FIELD_INFO(GyroRate),
+        BLACKBOARD_FIELD_INFO(CSSValid), BLACKBOARD_FIELD_INFO(CSSIllum), BLACKBOARD_FIELD_INFO(FSSValid), BLACKBOARD_FIELD_INFO(FSSSunAng),
+        BLACKBOARD_FIELD_INFO(STValid), BLACKBOARD_FIELD_INFO(STqn), BLACKBOARD_FIELD_INFO(AbsTime), BLACKBOARD_FIELD_INFO(GPSWeek),
+        BLACKBOARD_FIELD_INFO(GPSSec), BLACKBOARD_FIELD_INFO(GPSFracSec), BLACKBOARD_FIELD_INFO(GPSPosN), BLACKBOARD_FIELD_INFO(GPSVelN),
+        BLACKBOARD_FIELD_INFO(GPSPosW), BLACKBOARD_FIELD_INFO(GPSVelW), BLACKBOARD_FIELD_INFO(AccelAcc), BLACKBOARD_FIELD_INFO(WhlH)
+    };
+#undef BLACKBOARD_FIELD_INFO
+
+    /** \brief The field groups of BlackboardData a reader needs, resolved once (see blackboard_resolve_mask) into the
+     *  byte ranges of the cache lines that hold them, adjacent lines coalesced, so a read copies only those lines.
+     */
+    struct BlackboardFieldMask {
+        uint32_t fields;       // bits of BlackboardField
+        uint32_t range_count;
+        struct {
+            uint32_t offset;
+            uint32_t size;
+        } ranges[BLACKBOARD_MAX_RANGES];
+    };
+
+    /// \brief Returns the mask bit of a field group
+    inline uint32_t blackboard_field_bit(BlackboardField field) {return 1u << field;}
+
+    /// \brief Returns the mask bits of every field group
+    inline uint32_t blackboard_all_fields(void) {return (1u << BLACKBOARD_FIELD_COUNT) - 1;}
+
+    /// \brief Returns the field group with a name (as in BlackboardData), or BLACKBOARD_FIELD_COUNT if there is none
+    inline BlackboardField blackboard_field_from_name(const char *name)
+    {
+        int field = 0;
+        while (field < BLACKBOARD_FIELD_COUNT && strcmp(BLACKBOARD_FIELDS[field].name, name) != 0) field++;
+        return (BlackboardField)field;
+    }
+
+    /// \brief Resolves the field groups a reader needs into the cache line ranges to copy
+    inline void blackboard_resolve_mask(uint32_t fields, BlackboardFieldMask& mask)
+    {
+        const size_t line_count = (sizeof(BlackboardData) + BLACKBOARD_CACHE_LINE - 1)/BLACKBOARD_CACHE_LINE;
+        bool needed[line_count] = {};
+        for (int field = 0; field < BLACKBOARD_FIELD_COUNT; field++) {
+            if ((fields & (1u << field)) == 0) continue;
+            const BlackboardFieldInfo& info = BLACKBOARD_FIELDS[field];
+            for (size_t line = info.offset/BLACKBOARD_CACHE_LINE; line <= (info.offset + info.size - 1)/BLACKBOARD_CACHE_LINE; line++) needed[line] = true;
+        }
+        mask.fields = fields;
+        mask.range_count = 0;
+        for (size_t line = 0; line < line_count; line++) {
+            if (!needed[line]) continue;
+            size_t offset = line*BLACKBOARD_CACHE_LINE;
+            while (line + 1 < line_count && needed[line + 1]) line++;
+            mask.ranges[mask.range_count].offset = offset;
+            mask.ranges[mask.range_count].size = std::min((line + 1)*BLACKBOARD_CACHE_LINE, sizeof(BlackboardData)) - offset;
+            mask.range_count++;
+        }
+    }
+
+    /** \brief The blackboard of one spacecraft:  the data, followed by the seqlock sequence that versions it.
+     *
+     *  The writer makes the sequence odd before it changes the data and even again (one more) when it is done,
+     *  so a reader that sees the same even sequence before and after copying the data has a consistent copy.
+     *  The sequence follows the data so a writer that predates it still writes the data where it always has; its
+     *  sequence stays 0 and readers behave as they did before, unsynchronized.  Use blackboard_write_begin and
+     *  blackboard_write_end (or blackboard_publish) to write and blackboard_read to read.
+     *
+     *  The sequence doubles as the generation of the data:  it advances by 2 with each publish, so a reader that
+     *  remembers it can skip a tick when nothing was written.  It is also a (process shared) futex, so a reader can
+     *  block in blackboard_wait until the next publish instead of polling; the writer only makes the wake up system
+     *  call when waiters says someone is blocked.
+     *
+     *  Slots are cache line aligned, so the writer of one spacecraft does not false share with readers of another.
+     */
+    struct alignas(64) BlackboardSlot {
+        BlackboardData        data;
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> waiters;   // readers blocked in blackboard_wait
+    };
+
+    /** \brief One record of the history ring of a slot:  the data of one publish, versioned by its own seqlock.
+     *
+     *  A slot with a history of depth records keeps the data of its last depth publishes, the record of
+     *  generation g at index g % depth, so a reader that misses publishes can still see them (see
+     *  blackboard_history_at and blackboard_history_since).  The writer fills the record before it publishes
+     *  the slot.  data and published are laid out as a BlackboardSnapshot, so a record is read with one copy.
+     */
+    struct alignas(64) BlackboardHistoryRecord {
+        BlackboardData        data;
+        uint32_t              published;  // the slot sequence of the publish the record holds
+        std::atomic<uint32_t> sequence;
+    };
+
+    /** \brief The header of a multiple spacecraft blackboard segment, which is followed by slot_count BlackboardSlots
+     *  and then, if history_depth is not 0, history_depth BlackboardHistoryRecords for each slot.
+     *
+     *  A segment without a header (the original layout) is a single slot.  Whoever claims the zeroed magic first
+     *  writes the header, magic last; everyone else waits for the magic and checks the header (see blackboard_attach).
+     */
+    struct alignas(64) BlackboardSegmentHeader {
+        std::atomic<uint32_t> magic;  // BLACKBOARD_MAGIC once the rest of the header is written
+        uint32_t version;             // BLACKBOARD_VERSION
+        uint32_t slot_count;
+        uint32_t slot_size;           // sizeof(BlackboardSlot), to catch writers built with another layout
+        uint32_t history_depth;       // records of history per slot, 0 for none
+    };
+
+    /// \brief Returns the bytes of a segment of slot_count slots, or of the original single slot layout if slot_count is 0
+    inline size_t blackboard_segment_size(uint32_t slot_count, uint32_t history_depth = 0)
+    {
+        return slot_count == 0 ? sizeof(BlackboardSlot) :
+            sizeof(BlackboardSegmentHeader) + slot_count*(sizeof(BlackboardSlot) + history_depth*sizeof(BlackboardHistoryRecord));
+    }
+
+    /// \brief Returns a slot of a multiple spacecraft segment
+    inline BlackboardSlot* blackboard_slot(BlackboardSegmentHeader* header, uint32_t index)
+    {
+        return reinterpret_cast<BlackboardSlot *>(header + 1) + index;
+    }
+
+    /// \brief Returns the history_depth records of the history of a slot of a multiple spacecraft segment, or NULL if it has none
+    inline BlackboardHistoryRecord* blackboard_history(BlackboardSegmentHeader* header, uint32_t index)
+    {
+        if (header->history_depth == 0) return NULL;
+        return reinterpret_cast<BlackboardHistoryRecord *>(blackboard_slot(header, header->slot_count)) + index*header->history_depth;
+    }
+
+    /** \brief Claims the writing of a new segment header, or waits until whoever claimed it has written it.
+     *
+     *  The zeroed magic of a new segment is swapped for BLACKBOARD_INITIALIZING, so of several processes attaching
+     *  at once exactly one writes the header.  The others wait, up to BLACKBOARD_INIT_WAIT_MS, for the final magic.
+     *
+     *  @param magic  The magic word of the header
+     *  @return       true if the caller must write the header and then store the final magic (with release order)
+     */
+    inline bool blackboard_claim_header(std::atomic<uint32_t>& magic)
+    {
+        uint32_t expected = 0;
+        if (magic.compare_exchange_strong(expected, BLACKBOARD_INITIALIZING, std::memory_order_acquire)) return true;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(BLACKBOARD_INIT_WAIT_MS);
+        for (unsigned int spins = 0; magic.load(std::memory_order_acquire) == BLACKBOARD_INITIALIZING; spins++) {
+            if (spins < BLACKBOARD_SPINS_BEFORE_YIELD) continue;
+            if (std::chrono::steady_clock::now() > deadline) break; // the creator died part way... the caller sees the wrong magic
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    /** \brief Writes the header of a new (zeroed) multiple spacecraft segment, or checks the header of an existing one.
+     *
+     *  @param header         The header at the start of the mapped segment
+     *  @param slot_count     The slots the segment is created with; an existing segment may have more
+     *  @param history_depth  The history the segment is created with; an existing segment may have more
+     *  @return               false if the segment was made with a different layout or has fewer slots or less history,
+     *                        or its header was never finished
+     */
+    inline bool blackboard_attach(BlackboardSegmentHeader* header, uint32_t slot_count, uint32_t history_depth = 0)
+    {
+        if (blackboard_claim_header(header->magic)) {
+            header->version = BLACKBOARD_VERSION;
+            header->slot_count = slot_count;
+            header->slot_size = sizeof(BlackboardSlot);
+            header->history_depth = history_depth;
+            header->magic.store(BLACKBOARD_MAGIC, std::memory_order_release);
+        }
+        return header->magic.load(std::memory_order_acquire) == BLACKBOARD_MAGIC && header->version == BLACKBOARD_VERSION && header->slot_size == sizeof(BlackboardSlot) && header->slot_count >= slot_count &&
+            header->history_depth >= history_depth;
+    }
+
+    /// \brief A caller owned, cache line aligned copy of the blackboard data, filled by one copy under the seqlock
+    struct alignas(64) BlackboardSnapshot {
+        BlackboardData data;
+        uint32_t       sequence;  // the (even) seqlock sequence the data was copied at
+    };
+
+    static_assert(offsetof(BlackboardHistoryRecord, published) == offsetof(BlackboardSnapshot, sequence), "a history record is copied into a snapshot");
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "the blackboard sequence must be lock free to be shared between processes");
+    static_assert((sizeof(BlackboardData) + BLACKBOARD_CACHE_LINE - 1)/BLACKBOARD_CACHE_LINE <= 2*BLACKBOARD_MAX_RANGES, "a mask has room for every range");
+
+    /// \brief Makes a seqlock sequence odd before the data it versions changes
+    inline void blackboard_seqlock_begin(std::atomic<uint32_t>& sequence)
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release); // the odd sequence is visible before any of the data changes
+    }
+
+    /// \brief Makes a seqlock sequence even again once the data it versions has changed
+    inline void blackboard_seqlock_end(std::atomic<uint32_t>& sequence)
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst); // seq_cst orders it before a later waiters check
+    }
+
+    /** \brief Copies data versioned by a seqlock sequence, retrying only while the writer is updating it.
+     *
+     *  @param sequence  The seqlock sequence
+     *  @param copy      Copies the data; the copy may race with the writer, in which case it is discarded and made again
+     *  @return          The (even) sequence of the copy
+     */
+    template <typename Copy>
+    inline uint32_t blackboard_seqlock_read(const std::atomic<uint32_t>& sequence, Copy copy)
+    {
+        for (unsigned int spins = 0; ; spins++) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                copy();
+                std::atomic_thread_fence(std::memory_order_acquire); // the copy completes before the sequence is checked again
+                if (sequence.load(std::memory_order_relaxed) == before) return before;
+            }
+            if (spins >= BLACKBOARD_SPINS_BEFORE_YIELD) std::this_thread::yield(); // the writer may be descheduled mid-update
+        }
+    }
+
+    /** \brief Copies data versioned by a seqlock sequence, retrying only while the writer is updating it.
+     *
+     *  @param sequence  The seqlock sequence
+     *  @param copy      The copy
+     *  @param data      The data
+     *  @param size      The bytes to copy
+     *  @return          The (even) sequence of the copy
+     */
+    inline uint32_t blackboard_seqlock_read(const std::atomic<uint32_t>& sequence, void *copy, const void *data, size_t size)
+    {
+        return blackboard_seqlock_read(sequence, [copy, data, size]{memcpy(copy, data, size);});
+    }
+
+    /// \brief Starts an update of the blackboard data; there must be one writer at a time
+    inline void blackboard_write_begin(BlackboardSlot& slot)
+    {
+        blackboard_seqlock_begin(slot.sequence);
+    }
+
+    /// \brief Wakes the readers blocked in blackboard_wait
+    inline void blackboard_wake(BlackboardSlot& slot)
+    {
+#if defined(__linux__)
+        if (slot.waiters.load(std::memory_order_seq_cst) != 0) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&slot.sequence), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        }
+#endif
+    }
+
+    /// \brief Finishes an update of the blackboard data started by blackboard_write_begin, waking any blocked readers
+    inline void blackboard_write_end(BlackboardSlot& slot)
+    {
+        blackboard_seqlock_end(slot.sequence);
+        blackboard_wake(slot);
+    }
+
+    /// \brief Replaces the blackboard data as one update
+    inline void blackboard_publish(BlackboardSlot& slot, const BlackboardData& data)
+    {
+        blackboard_write_begin(slot);
+        memcpy(&slot.data, &data, sizeof(data));
+        blackboard_write_end(slot);
+    }
+
+    /** \brief Replaces the blackboard data as one update, keeping it in the history of the slot.
+     *
+     *  @param slot           The blackboard slot
+     *  @param history        The history of the slot, from blackboard_history
+     *  @param history_depth  The records of the history
+     *  @param data           The new data
+     */
+    inline void blackboard_publish(BlackboardSlot& slot, BlackboardHistoryRecord* history, uint32_t history_depth, const BlackboardData& data)
+    {
+        if (history != NULL) {
+            uint32_t published = (slot.sequence.load(std::memory_order_relaxed) | 1) + 1;
+            BlackboardHistoryRecord& record = history[(published >> 1) % history_depth];
+            blackboard_seqlock_begin(record.sequence);
+            memcpy(&record.data, &data, sizeof(data));
+            record.published = published;
+            blackboard_seqlock_end(record.sequence);
+        }
+        blackboard_publish(slot, data);
+    }
+
+    /** \brief Copies a consistent snapshot of the blackboard data, retrying only while the writer is updating it.
+     *
+     *  @param slot      The blackboard slot
+     *  @param snapshot  The copy of the data
+     *  @return          The (even) sequence of the copy
+     */
+    inline uint32_t blackboard_read(const BlackboardSlot& slot, BlackboardData& snapshot)
+    {
+        return blackboard_seqlock_read(slot.sequence, &snapshot, &slot.data, sizeof(snapshot));
+    }
+
+    /** \brief Copies a consistent snapshot of some of the blackboard data, only the cache lines that hold the fields of a mask.
+     *
+     *  @param slot      The blackboard slot
+     *  @param mask      The fields to copy, from blackboard_resolve_mask
+     *  @param snapshot  The copy of the data; the rest of it is left as it was
+     *  @return          The (even) sequence of the copy
+     */
+    inline uint32_t blackboard_read(const BlackboardSlot& slot, const BlackboardFieldMask& mask, BlackboardData& snapshot)
+    {
+        return blackboard_seqlock_read(slot.sequence, [&slot, &mask, &snapshot]{
+            for (uint32_t i = 0; i < mask.range_count; i++) {
+                memcpy(reinterpret_cast<char *>(&snapshot) + mask.ranges[i].offset, reinterpret_cast<const char *>(&slot.data) + mask.ranges[i].offset,
+                    mask.ranges[i].size);
+            }
+        });
+    }
+
+    /// \brief Copies a history record into a snapshot, whose sequence is then the slot sequence of the publish the record holds
+    inline void blackboard_read_record(const BlackboardHistoryRecord& record, BlackboardSnapshot& snapshot)
+    {
+        blackboard_seqlock_read(record.sequence, &snapshot, &record, offsetof(BlackboardHistoryRecord, published) + sizeof(record.published));
+    }
+
+    /** \brief Copies the latest publish at or before a time from the history of a slot.
+     *
+     *  @param slot           The blackboard slot
+     *  @param history        The history of the slot, from blackboard_history
+     *  @param history_depth  The records of the history
+     *  @param abs_time       The time, seconds since J2000 (AbsTime)
+     *  @param snapshot       The copy of the publish
+     *  @return               false if every publish still in the history is after the time
+     */
+    inline bool blackboard_history_at(const BlackboardSlot& slot, const BlackboardHistoryRecord* history, uint32_t history_depth, double abs_time,
+        BlackboardSnapshot& snapshot)
+    {
+        uint32_t published = slot.sequence.load(std::memory_order_acquire) & ~1u;
+        for (uint32_t i = 0; i < history_depth && published != 0; i++, published -= 2) {
+            blackboard_read_record(history[(published >> 1) % history_depth], snapshot);
+            if (snapshot.sequence != published) return false; // overwritten by a newer publish, so the rest are too
+            if (snapshot.data.AbsTime <= abs_time) return true;
+        }
+        return false;
+    }
+
+    /** \brief Copies the publishes after a generation from the history of a slot, oldest first.
+     *
+     *  Publishes that have already left the history are skipped.  Pass the generation of the last snapshot
+     *  copied (its sequence / 2) to the next call to continue from it.
+     *
+     *  @param slot           The blackboard slot
+     *  @param history        The history of the slot, from blackboard_history
+     *  @param history_depth  The records of the history
+     *  @param generation     The generation already seen
+     *  @param snapshots      The copies of the publishes
+     *  @param count          The most publishes to copy
+     *  @return               The publishes copied
+     */
+    inline uint32_t blackboard_history_since(const BlackboardSlot& slot, const BlackboardHistoryRecord* history, uint32_t history_depth,
+        uint32_t generation, BlackboardSnapshot* snapshots, uint32_t count)
+    {
+        uint32_t current = slot.sequence.load(std::memory_order_acquire) >> 1;
+        if (history_depth == 0 || (int32_t)(current - generation) <= 0) return 0;
+        uint32_t first = (current - generation > history_depth) ? current - history_depth + 1 : generation + 1;
+        uint32_t last = first + std::min(count, current - first + 1);
+        uint32_t copied = 0;
+        for (uint32_t g = first; g != last; g++) {
+            blackboard_read_record(history[g % history_depth], snapshots[copied]);
+            if (snapshots[copied].sequence == 2*g) copied++; // else overwritten by a newer publish since
+        }
+        return copied;
+    }
+
+    /// \brief Returns the generation of the blackboard data, the number of publishes so far
+    inline uint32_t blackboard_generation(const BlackboardSlot& slot)
+    {
+        return slot.sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+    /** \brief Blocks until the blackboard data is published past a sequence, or a timeout.
+     *
+     *  A writer that predates the sequence never advances it, so callers that must also see such writers should
+     *  use a timeout no longer than they would have polled for.  Off Linux this sleeps for the timeout.
+     *
+     *  @param slot      The blackboard slot
+     *  @param sequence  The sequence already seen, e.g. from blackboard_read
+     *  @param timeout   The longest time to wait
+     *  @return          true if a publish completed after sequence, false on timeout
+     */
+    inline bool blackboard_wait(BlackboardSlot& slot, uint32_t sequence, std::chrono::microseconds timeout)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            uint32_t current = slot.sequence.load(std::memory_order_acquire);
+            if (current != sequence && (current & 1) == 0) return true;
+            std::chrono::nanoseconds remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining.count() <= 0) return false;
+#if defined(__linux__)
+            struct timespec wait_time;
+            wait_time.tv_sec = remaining.count() / 1000000000;
+            wait_time.tv_nsec = remaining.count() % 1000000000;
+            slot.waiters.fetch_add(1, std::memory_order_seq_cst); // ordered before the kernel checks the sequence
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&slot.sequence), FUTEX_WAIT, current, &wait_time, NULL, 0); // returns at once if the sequence moved on; woken or not, the loop rechecks
+            slot.waiters.fetch_sub(1, std::memory_order_relaxed);
+#else
+            std::this_thread::sleep_for(remaining);
+#endif
+        }
+    }
 }
 
 #endif
@@ -0,0 +1,62 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42BINARYFRAME_HPP
+#define NOS3_SIM42BINARYFRAME_HPP
+
+#include <cstdint>
+
+namespace Nos3
+{
+    /** \brief Binary 42 telemetry stream, an alternative to the ASCII frames, selected with telemetry-format binary.
+     *
+     *  \details The stream is a sequence of messages, each a Sim42BinaryHeader followed by length bytes of
+     *  payload, all in host byte order (the stream is meant for 42 and its consumers on one host).
+     *
+     *  A SIM42BIN_FIELD_TABLE message describes the fields of the data messages that follow it.  Its
+     *  payload is a uint32_t field count, then for each field a uint32_t number of doubles, a uint32_t key
+     *  length, and the key text (e.g. SC[0].PosN, no terminator or padding).  The sender sends a table
+     *  first on each connection, and again whenever its fields change.
+     *
+     *  A SIM42BIN_DATA message is one frame.  Its payload is a Sim42BinaryTime, then the doubles of every
+     *  field of the current table, in table order.
+     */
+    struct Sim42BinaryHeader
+    {
+        char     magic[4];   // SIM42BIN_MAGIC
+        uint32_t type;       // SIM42BIN_FIELD_TABLE or SIM42BIN_DATA
+        uint32_t length;     // bytes of payload after this header
+        uint32_t sequence;   // frame number, from 1, of a data message, 0 for a field table, for diagnostics
+    };
+
+    /// \brief The time of a binary frame, the same values as the TIME line of an ASCII frame
+    struct Sim42BinaryTime
+    {
+        int32_t year;
+        int32_t doy;
+        int32_t hour;
+        int32_t minute;
+        double  second;
+    };
+
+    static const char SIM42BIN_MAGIC[4] = {'4', '2', 'B', 'F'};
+    static const uint32_t SIM42BIN_FIELD_TABLE = 1;
+    static const uint32_t SIM42BIN_DATA = 2;
+    static const uint32_t SIM42BIN_MAX_LENGTH = 64*1024*1024;  // longer messages are treated as a corrupt stream
+}
+
+#endif
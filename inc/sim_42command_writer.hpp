@@ -0,0 +1,132 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42COMMANDWRITER_HPP
+#define NOS3_SIM42COMMANDWRITER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sim_42connector.hpp>
+
+namespace Nos3
+{
+    /// \brief Statistics of a Sim42CommandWriter
+    struct Sim42CommandWriterStats
+    {
+        uint64_t queue_depth;        // commands waiting to be written now
+        uint64_t max_queue_depth;    // most commands ever waiting to be written
+        uint64_t commands_sent;      // commands completely written
+        uint64_t commands_dropped;   // commands dropped because the queue stayed full or the connection was lost mid command
+        uint64_t writes;             // writev calls that wrote something, commands_sent/writes is the coalescing achieved
+        double mean_latency_ms;      // mean time from queueing a command to it being completely written
+        double max_latency_ms;       // longest time from queueing a command to it being completely written
+    };
+
+    /** \brief Class for sending commands to a 42 command socket from a background writer thread.
+     *
+     *  \details send() queues the command and returns without touching the socket.  The writer thread
+     *  connects (and keeps reconnecting after a failure, however long 42 is away) with a Sim42Connector,
+     *  then takes every command queued since its last write and writes them with one writev.  With no
+     *  batch window, commands are only coalesced under backpressure, i.e. when they queue up while a write
+     *  is in progress or the socket is down; otherwise each command goes out as soon as it is queued.  With
+     *  a batch window, the writer waits that long after the first queued command (or until the queue is
+     *  full) before writing, so commands issued in the same tick go out together.  Partial writes are
+     *  continued where they stopped.  When the connection fails part way through a command, that command
+     *  is dropped, since its remainder would be garbage on the new connection, and the commands after it
+     *  are written once reconnected.  The queue is bounded; when it is full send() waits up to the queue
+     *  timeout for room, then drops the command.
+     */
+    class Sim42CommandWriter
+    {
+    public:
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking the endpoint, connection retry settings, and queue settings.  Starts the writer thread.
+        /// @param  host                     The host name or IP address of the 42 server
+        /// @param  port                     The command port number of the 42 server
+        /// @param  max_connection_attempts  The number of consecutive failed attempts before giving up
+        /// @param  retry_wait_seconds       The longest time to wait between connection attempts
+        /// @param  max_queue_depth          The most commands that can wait to be written
+        /// @param  queue_timeout_ms         The longest time send() waits for room in a full queue
+        /// @param  batch_window_us          How long to collect commands after the first is queued before writing them, 0 to write at once
+        Sim42CommandWriter(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds,
+            size_t max_queue_depth, int queue_timeout_ms, int batch_window_us = 0);
+        /// \brief Destructor.  Stops the writer thread, dropping any commands not yet written, and closes the socket.
+        ~Sim42CommandWriter(void);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Queues a command to be written.
+        /// @param  command  The command text
+        /// @returns         false if the command was dropped because the queue stayed full
+        bool send(const std::string& command);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns true if the command socket is connected
+        bool is_connected(void) const;
+        /// \brief Returns the statistics of the commands written so far
+        Sim42CommandWriterStats get_stats(void) const;
+        //@}
+
+    private:
+        // Disable copying and assignment
+        Sim42CommandWriter(const Sim42CommandWriter& other);
+        Sim42CommandWriter& operator=(const Sim42CommandWriter& other);
+
+        // Helper struct for a queued command
+        struct Command
+        {
+            std::string text;
+            std::chrono::steady_clock::time_point queued;
+        };
+
+        // Private helper methods
+        void writer(void);
+        size_t write_commands(int socket_fd, std::vector<Command>& commands);
+        void close_socket(void);
+
+        // Private data
+        std::string _endpoint;
+        size_t _max_queue_depth;
+        std::chrono::milliseconds _queue_timeout;
+        std::chrono::microseconds _batch_window;
+        Sim42Connector _connector;
+
+        mutable std::mutex _mutex;  // protects all data below
+        std::condition_variable _queue_cv;   // signalled when commands are queued or terminating
+        std::condition_variable _space_cv;   // signalled when the queue has room
+        std::deque<Command> _queue;
+        bool _terminating;
+        int _socket_fd;
+        Sim42CommandWriterStats _stats;
+        double _total_latency_ms;
+
+        std::thread _writer_thread;  // last, so it starts after everything it uses is constructed
+    };
+}
+
+#endif
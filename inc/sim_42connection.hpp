@@ -0,0 +1,213 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42CONNECTION_HPP
+#define NOS3_SIM42CONNECTION_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sim_42connector.hpp>
+#include <sim_42data_point.hpp>
+#include <sim_42frame_reader.hpp>
+#include <sim_42frame_recorder.hpp>
+#include <sim_42key_filter.hpp>
+#include <sim_spsc_queue.hpp>
+
+namespace Nos3
+{
+    /// \brief What a Sim42Connection does with frames read faster than they can be parsed
+    enum Sim42OverloadPolicy
+    {
+        SIM42_OVERLOAD_BLOCK,        // stop reading until the parser catches up... no frame is lost, 42 is slowed by TCP flow control
+        SIM42_OVERLOAD_DROP_NEWEST,  // drop a frame read while the queue is full
+        SIM42_OVERLOAD_LATEST_ONLY   // parse only the newest queued frame, dropping older ones, and drop a frame read while the queue is full
+    };
+
+    /// \brief Settings of the read/parse pipeline of a Sim42Connection
+    struct Sim42PipelineOptions
+    {
+        size_t queue_depth;                   // the most frames read but not yet parsed
+        Sim42OverloadPolicy overload_policy;
+        bool binary_frames;                   // the stream is binary (see Sim42BinaryHeader) rather than ASCII frames
+
+        Sim42PipelineOptions() : queue_depth(8), overload_policy(SIM42_OVERLOAD_BLOCK), binary_frames(false) {}
+        Sim42PipelineOptions(size_t depth, Sim42OverloadPolicy policy, bool binary = false)
+            : queue_depth(depth), overload_policy(policy), binary_frames(binary) {}
+
+        /// \brief Returns the policy named block, drop-newest, or latest-only... block, with a warning, for any other name
+        static Sim42OverloadPolicy parse_overload_policy(const std::string& name);
+    };
+
+    /// \brief Statistics of the read/parse pipeline of a Sim42Connection
+    struct Sim42PipelineStats
+    {
+        uint64_t queue_depth;      // frames read but not yet parsed now
+        uint64_t max_queue_depth;  // most frames ever read but not yet parsed
+        uint64_t frames_read;      // frames read from the socket
+        uint64_t frames_parsed;    // frames parsed and handed to the subscribers
+        uint64_t frames_dropped;   // frames read but never handed to the subscribers, by the overload policy or because they were malformed
+    };
+
+    /** \brief Class for one telemetry connection to a 42 server endpoint.
+     *
+     *  \details The connection owns the socket and the reader thread for one host:port.  The reader thread
+     *  connects in the background, and reconnects with backoff whenever the connection drops, so no one
+     *  waits on a slow or missing 42.  Each frame is parsed once into a Sim42DataPoint and the same data
+     *  point is handed to every subscriber.  Frames are parsed lazily (see Sim42DataPoint) when every
+     *  subscriber asked for lazy parsing, and fully otherwise.  Likewise, when every subscriber has a key
+     *  filter, lines that none of the filters select are skipped as they are read.
+     *  Reading and parsing are separate threads connected by a bounded single producer, single consumer
+     *  queue of frame arenas, so a slow parse or subscriber does not stop the socket being drained;
+     *  the overload policy decides what happens when the queue fills.  A binary stream is read the same
+     *  way, a data message at a time, and key filters do not apply to it.  The connection can record its
+     *  frames to a log (see record_to); while it does, frames are read and recorded whole, before any key
+     *  filter, so the log replays exactly what 42 sent.  Frames the overload policy drops are not recorded.
+     *  Subscriber callbacks are called on the parser thread, without any lock held, so a callback may
+     *  add or remove subscribers; callbacks should return quickly.  Connections are normally shared
+     *  through Sim42ConnectionManager rather than created directly.
+     */
+    class Sim42Connection
+    {
+    public:
+        /// \brief Type of the callback that receives each parsed frame
+        typedef std::function<void(const boost::shared_ptr<Sim42DataPoint>&)> FrameCallback;
+
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking the endpoint and connection retry settings.
+        /// @param  host                     The host name or IP address of the 42 server
+        /// @param  port                     The port number of the 42 server
+        /// @param  max_connection_attempts  The number of consecutive failed attempts before giving up, negative to never give up
+        /// @param  retry_wait_seconds       The longest time to wait between connection attempts
+        /// @param  pipeline                 The queue depth and overload policy between the reader and parser threads
+        Sim42Connection(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds,
+            const Sim42PipelineOptions& pipeline = Sim42PipelineOptions());
+        /// \brief Destructor.  Stops the reader and parser threads and closes the socket.
+        ~Sim42Connection(void);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Starts the reader thread, which connects to 42 in the background, and the parser thread.
+        void start(void);
+
+        /// \brief Adds a subscriber that is called with every parsed frame.
+        /// @param  id            The subscription identifier
+        /// @param  callback      The callback to call with each frame
+        /// @param  lazy_parsing  true if the subscriber reads few keys, so frames need not be parsed fully
+        /// @param  filter        The keys the subscriber reads, NULL or empty for every key
+        void add_subscriber(uint64_t id, FrameCallback callback, bool lazy_parsing = false,
+            const boost::shared_ptr<const Sim42KeyFilter>& filter = boost::shared_ptr<const Sim42KeyFilter>());
+
+        /// \brief Removes a subscriber.  The callback is not called again once this returns, though a call already
+        ///        in progress may still be running; see wait_for_callbacks.
+        /// @param  id  The subscription identifier
+        /// @return     The number of subscribers that remain
+        size_t remove_subscriber(uint64_t id);
+
+        /// \brief Waits until no callback is running, so a removed subscriber can be destroyed.  Returns at once
+        ///        when called from a callback, which would otherwise wait for itself.
+        void wait_for_callbacks(void);
+
+        /// \brief Records every frame to a 42 frame log (see Sim42FrameRecorder) until the connection closes.
+        /// @param  filename  The log file; the connection records to one file, so a different file than one already recording is refused
+        /// @return           true if the connection is recording to the file
+        bool record_to(const std::string& filename);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the host:port string identifying this connection
+        std::string get_endpoint(void) const {return _connector.get_endpoint();}
+        /// \brief Returns true while the socket is connected
+        bool is_connected(void) const {return _connected;}
+        /// \brief Returns the frame reader, e.g. for byte and frame rate statistics
+        const Sim42FrameReader& get_frame_reader(void) const {return _frame_reader;}
+        /// \brief Returns the statistics of the read/parse pipeline
+        Sim42PipelineStats get_pipeline_stats(void) const;
+        /// \brief Returns the settings of the read/parse pipeline
+        const Sim42PipelineOptions& get_pipeline_options(void) const {return _pipeline;}
+        /// \brief Returns true if called on the parser thread, i.e. from a subscriber callback
+        bool is_callback_thread(void) const;
+        //@}
+
+    private:
+        // Private helper methods
+        void telemetry_socket_reader(void);
+        void telemetry_parser(void);
+        bool read_binary_frame(Sim42FrameArena& arena);
+        bool queue_frame(boost::shared_ptr<Sim42FrameArena>& arena);
+        void wake(const std::atomic<bool>& waiting);
+        void remove_subscriber_locked(uint64_t id);
+        void update_filter_locked(void);
+
+        // Private data
+        // ... connection data
+        Sim42Connector _connector;
+        int _socket_fd;
+        std::mutex _socket_mutex;  // protects _socket_fd, so the destructor can shut down the socket safely
+        std::atomic<bool> _connected;
+
+        // ... reader thread / thread state data
+        std::thread *_reader_thread;
+        std::atomic<bool> _not_terminating;
+        Sim42FrameReader _frame_reader;
+        boost::shared_ptr<const Sim42Schema> _field_table;  // fields of the binary stream, from its last field table message
+        boost::shared_ptr<Sim42FrameRecorder> _recorder;    // records every frame, NULL if not recording, replaced with boost::atomic_store
+        std::mutex _recorder_mutex;                         // serializes record_to
+
+        // ... parser thread and the queue of frames read but not parsed
+        Sim42PipelineOptions _pipeline;
+        SimSpscQueue<boost::shared_ptr<Sim42FrameArena> > _queue;
+        std::thread *_parser_thread;
+        std::mutex _wait_mutex;              // held to sleep on, or wake, _wait_cv
+        std::condition_variable _wait_cv;    // signalled when the queue gains a frame or room, or when terminating
+        std::atomic<bool> _reader_waiting;   // the reader is (about to be) asleep, waiting for room
+        std::atomic<bool> _parser_waiting;   // the parser is (about to be) asleep, waiting for a frame
+        std::atomic<uint64_t> _max_queue_depth;
+        std::atomic<uint64_t> _frames_read;
+        std::atomic<uint64_t> _frames_parsed;
+        std::atomic<uint64_t> _frames_dropped;
+
+        // ... subscribers
+        struct Subscriber
+        {
+            boost::shared_ptr<const FrameCallback> callback;  // shared, so the parser thread can call it without holding the lock
+            bool lazy_parsing;
+            boost::shared_ptr<const Sim42KeyFilter> filter;
+        };
+        std::map<uint64_t, Subscriber> _subscribers;
+        std::mutex _subscriber_mutex;  // protects _subscribers
+        std::vector<std::pair<uint64_t, boost::shared_ptr<const FrameCallback> > > _callbacks;  // the parser thread's copy of the subscribers
+        std::mutex _callback_mutex;    // held by the parser thread while it calls the callbacks
+        std::atomic<size_t> _eager_subscribers;  // subscribers that did not ask for lazy parsing
+        boost::shared_ptr<const Sim42KeyFilter> _filter;  // union of the subscriber filters, NULL for every key, replaced with boost::atomic_store
+    };
+}
+
+#endif
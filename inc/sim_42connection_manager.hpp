@@ -0,0 +1,87 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42CONNECTIONMANAGER_HPP
+#define NOS3_SIM42CONNECTIONMANAGER_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sim_42connection.hpp>
+
+namespace Nos3
+{
+    /** \brief Process wide manager of 42 telemetry connections.
+     *
+     *  \details There is one Sim42Connection per host:port.  The first subscriber to an endpoint
+     *  creates and connects it, later subscribers share it, and the last unsubscribe closes it.  This
+     *  way every simulator in nos3-all-simulators that reads the same 42 endpoint shares one socket,
+     *  one reader thread, and one parse of each frame.  A new connection is started only once its first
+     *  subscriber is added, so that subscriber gets every frame from the first one on.
+     */
+    class Sim42ConnectionManager
+    {
+    public:
+        /// Manager is implemented as a Singleton
+        static Sim42ConnectionManager& Instance();
+
+        /** \brief Subscribes to the frames of a 42 endpoint, starting a background connection to it if needed.
+         *
+         * @param       host                     The host name or IP address of the 42 server.
+         * @param       port                     The port number of the 42 server.
+         * @param       max_connection_attempts  The number of times to retry a failed connection (used when the connection is created).
+         * @param       retry_wait_seconds       The time to wait between connection attempts (used when the connection is created).
+         * @param       callback                 The callback to call with each parsed frame.
+         * @param       lazy_parsing             true if the subscriber reads few keys, so frames need not be parsed fully.
+         * @param       filter                   The keys the subscriber reads, NULL or empty for every key.
+         * @param       pipeline                 The read/parse queue depth and overload policy (used when the connection is created).
+         * @param       record_file              The 42 frame log to record the connection's frames to, empty for none (see Sim42Connection::record_to).
+         * @returns                              A subscription identifier.
+         */
+        uint64_t subscribe(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds,
+            Sim42Connection::FrameCallback callback, bool lazy_parsing = false,
+            const boost::shared_ptr<const Sim42KeyFilter>& filter = boost::shared_ptr<const Sim42KeyFilter>(),
+            const Sim42PipelineOptions& pipeline = Sim42PipelineOptions(), const std::string& record_file = std::string());
+
+        /// \brief Removes a subscription, closing the connection when it was the last one for the endpoint.  Once this
+        ///        returns the callback is not called again, and is not running, unless this is called from a callback.
+        /// @param  subscription  The subscription identifier returned by subscribe
+        void unsubscribe(uint64_t subscription);
+
+        /// \brief Returns the read/parse pipeline statistics of the connection of a subscription, all zero if there is none
+        /// @param  subscription  The subscription identifier returned by subscribe
+        Sim42PipelineStats get_pipeline_stats(uint64_t subscription);
+
+    private:
+        Sim42ConnectionManager() : _next_subscription(1) {}
+
+        // Disable copying and assignment
+        Sim42ConnectionManager(const Sim42ConnectionManager& other);
+        Sim42ConnectionManager& operator=(const Sim42ConnectionManager& other);
+
+        // Private data
+        std::mutex _mutex;  // protects all data below
+        uint64_t _next_subscription;
+        std::map<std::string, boost::shared_ptr<Sim42Connection> > _connections;  // keyed by host:port
+        std::map<uint64_t, std::string> _subscriptions;                            // subscription to host:port
+    };
+}
+
+#endif
@@ -0,0 +1,115 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42CONNECTOR_HPP
+#define NOS3_SIM42CONNECTOR_HPP
+
+#include <sys/socket.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nos3
+{
+    /** \brief Class for connecting a TCP client socket to a 42 server with backoff.
+     *
+     *  \details connect() is meant to be called on a background thread.  Failed attempts are retried
+     *  with an exponential backoff, starting at MIN_RETRY_WAIT_MS and capped at the configured retry wait.
+     *  Only the first connect() gives up:  after max_connection_attempts failures once it has also waited
+     *  max_connection_attempts times the retry wait, the same tolerance as retrying at the full wait.  Once
+     *  connected, later calls (reconnects after a lost connection) retry until they connect or stop() is called,
+     *  so 42 can be restarted without losing the connection for good.
+     *  Resolved addresses are cached process wide per host:port and only resolved again when connecting
+     *  to every cached address fails.  stop() interrupts any wait or connect in progress, so owners can
+     *  shut down promptly even while 42 is unreachable.
+     */
+    class Sim42Connector
+    {
+    public:
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking the endpoint and connection retry settings.
+        /// @param  host                     The host name or IP address of the 42 server
+        /// @param  port                     The port number of the 42 server
+        /// @param  max_connection_attempts  The number of consecutive failed attempts before the first connect gives up, negative to never give up
+        /// @param  retry_wait_seconds       The longest time to wait between connection attempts
+        Sim42Connector(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /** \brief Connects a socket to the 42 server, retrying with backoff.
+         *
+         * @param       socket_fd  The connected socket on success.
+         * @returns                true if the socket connected, false if the first connect's attempts ran out or stop() was called.
+         */
+        bool connect(int &socket_fd);
+
+        /// \brief Interrupts connect(), now and in the future.
+        void stop(void);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the host:port string identifying the endpoint
+        std::string get_endpoint(void) const {return _host + ":" + std::to_string(_port);}
+        /// \brief Returns true once stop() has been called
+        bool is_stopped(void) const;
+        //@}
+
+        static const int MIN_RETRY_WAIT_MS = 250;
+        static const int CONNECT_TIMEOUT_MS = 5000;
+
+    private:
+        // Helper struct for a cached resolved address
+        struct Address
+        {
+            int family;
+            int socktype;
+            int protocol;
+            struct sockaddr_storage addr;
+            socklen_t addrlen;
+        };
+
+        // Private helper methods
+        bool resolve(std::vector<Address>& addresses, bool refresh);
+        bool connect_once(const std::vector<Address>& addresses, int &socket_fd);
+        bool wait_for_connect(int socket_fd);
+        bool wait(std::chrono::milliseconds duration);
+
+        // Private data
+        std::string _host;
+        uint16_t _port;
+        int _max_connection_attempts;
+        int _retry_wait_seconds;
+        bool _connected_once;  // reconnects never give up
+
+        mutable std::mutex _mutex;  // protects _stopping
+        std::condition_variable _stop_cv;
+        bool _stopping;
+
+        // ... process wide resolver cache, keyed by host:port
+        static std::mutex _cache_mutex;
+        static std::map<std::string, std::vector<Address> > _cache;
+    };
+}
+
+#endif
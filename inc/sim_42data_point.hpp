@@ -18,18 +18,58 @@
 #ifndef NOS3_SIM42DATAPOINT_HPP
 #define NOS3_SIM42DATAPOINT_HPP
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+
+#include <boost/shared_ptr.hpp>
 
 #include <sim_i_data_point.hpp>
+#include <sim_42binary_frame.hpp>
+#include <sim_42frame_arena.hpp>
+#include <sim_42key_filter.hpp>
 
 namespace Nos3
 {
+    /// \brief Location of one numeric field in Sim42NumericFields::values
+    struct Sim42NumericField
+    {
+        std::string_view key;  // view into the data point the fields were parsed from
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /** \brief Every numeric field of a 42 frame, parsed in one pass by Sim42DataPoint::parse_numeric_fields.
+     *
+     *  Fields are sorted by key.  Reuse one object from frame to frame to avoid allocating.
+     */
+    struct Sim42NumericFields
+    {
+        std::vector<Sim42NumericField> fields;
+        std::vector<double> values;
+
+        /// \brief Returns the elements of a field, or NULL if the field is not numeric or not in the frame
+        /// @param key   The key of the field
+        /// @param size  The number of elements of the field, if not NULL
+        const double* find(std::string_view key, uint32_t *size = NULL) const;
+    };
 
     /** \brief Class to contain an entry of 42 simulation data.
      *
+     *  \details The frame text is kept in one Sim42FrameArena, and the lines, keys, and values are views
+     *  into it, so building a data point copies the frame at most once and allocates nothing once the
+     *  arena pool is warm.  Data points are immutable once constructed, and copies share the arena;
+     *  parse_time, kept for compatibility, copies the arena before changing it.
+     *
+     *  A lazy data point only splits the frame into lines and parses the TIME line when constructed.
+     *  Any other key is located by scanning the lines the first time it is asked for, and remembered,
+     *  which is much cheaper for consumers that read a handful of the hundreds of keys in a frame.
+     *
+     *  A binary data point holds the doubles of a binary frame (see Sim42BinaryHeader) rather than text.
+     *  get_doubles and get_array copy them directly; get_value_view formats a value as text the first
+     *  time it is asked for.  It has no lines or text of its own; format_text produces the ASCII frame.
      */
     class Sim42DataPoint : public SimIDataPoint
     {
@@ -41,45 +81,175 @@ namespace Nos3
          */
         Sim42DataPoint() {};
         /** \brief Constructor from a text message of string lines.
-         *  Just sets the lines of data.
+         *  Copies the lines into an arena.
          */
         Sim42DataPoint(std::vector<std::string> &message);
+        /** \brief Constructor from the text of a message, lines separated by new lines.
+         *  Copies the text into an arena.  If lazy, keys are located on first access.
+         */
+        Sim42DataPoint(const char *text, size_t length, bool lazy = false);
+        /** \brief Constructor from the text of a message, lines separated by new lines, held by an owner.
+         *  Does not copy the text, which must stay unchanged while owner is referenced.  If lazy, keys are located on first access.
+         */
+        Sim42DataPoint(const char *text, size_t length, const boost::shared_ptr<const void>& owner, bool lazy = false);
+        /** \brief Constructor from an arena with the text of a message, lines separated by new lines.
+         *  Takes over the arena, which must not be changed afterwards.  If lazy, keys are located on first access.
+         *  If the arena has a field_table, its text is the payload of a binary data message, and lazy is ignored.
+         */
+        Sim42DataPoint(const boost::shared_ptr<Sim42FrameArena>& arena, bool lazy = false);
         //@}
 
         /// @name Mutators
         //@{
         /// \brief Parses a string containing time of the form YEAR-DOY-HH:MM:SS.SSS
-        ///        and puts the results in the _key_value map.
+        ///        and adds the YEAR, DOY, HOUR, MINUTE, SECOND, MONTH, DAY, and ABSTIME keys.
+        ///        Does nothing if the data point already has a time, since its keys are kept, as before.
+        ///        The frame is copied into a new arena first, so copies sharing the old one (and other threads
+        ///        reading them) are not changed.  Shared snapshots, e.g. from get_data_point(), must still be copied
+        ///        before calling this, like any other mutator.
         void parse_time(const std::string& value);
         //@}
 
         /// @name Accessors
         //@{
+        /// \brief Returns true if keys are located on first access rather than when constructed
+        bool is_lazy(void) const {return _arena && _arena->lazy;}
+
+        /// \brief Returns true if the data point holds a frame, false if it is empty or its frame was rejected as malformed
+        bool is_valid(void) const {return _arena && !_arena->malformed;}
+
+        /// \brief Returns true if the data point holds a binary frame rather than text
+        bool is_binary(void) const {return _arena && _arena->field_table;}
+
+        /// \brief Formats the 42 simulation data point as the text of an ASCII 42 frame
+        /// @param text  The text, replaced:  the frame text itself for a text data point, formatted for a binary one
+        void format_text(std::string& text) const;
+
         /// \brief Returns one long single string representation of the 42 simulation data point
         /// @return     A long single string representation of the 42 simulation data point
         std::string to_string(void) const;
 
         /// \brief Returns the lines stored in the 42 simulation data point
-        /// @return     A vector of strings representing the 42 simulation data point
-        std::vector<std::string> get_lines(void) const {return _lines;}
+        /// @return     A vector of strings representing the 42 simulation data point (copies; see get_line_views)
+        std::vector<std::string> get_lines(void) const;
+
+        /// \brief Returns the lines stored in the 42 simulation data point, without copying them
+        /// @return     Views of the lines of the 42 simulation data point, without new lines, valid while the data point is
+        const std::vector<std::string_view>& get_line_views(void) const {return _arena ? _arena->lines : empty_lines();}
+
+        /// \brief Returns the text of the 42 simulation data point
+        /// @return     The lines of the 42 simulation data point, each ending in a new line, valid while the data point is
+        std::string_view get_text(void) const {return _arena ? _arena->frame : std::string_view();}
 
         /// \brief Returns the value for the key stored in the 42 simulation data point
         /// @param key  The key to find
-        /// @return     The value corresponding to the input key
-        std::string get_value_for_key(std::string key);
+        /// @return     The value corresponding to the input key, or an empty string if the key is not present
+        std::string get_value_for_key(const std::string& key) const {return std::string(get_value_view(key));}
+
+        /// \brief Returns the value for the key stored in the 42 simulation data point, without copying it
+        /// @param key  The key to find
+        /// @return     A view of the value corresponding to the input key, valid while the data point is, or an empty view if the key is not present
+        std::string_view get_value_view(std::string_view key) const;
+
+        /// \brief Returns true if the 42 simulation data point has a (well formed) TIME line, so the time accessors are valid
+        bool has_time(void) const {return _arena && _arena->time.valid;}
+        /// \brief Returns the year of the TIME line
+        int get_year(void) const {return has_time() ? _arena->time.year : 0;}
+        /// \brief Returns the day of year of the TIME line
+        int get_doy(void) const {return has_time() ? _arena->time.doy : 0;}
+        /// \brief Returns the month computed from the TIME line
+        int get_month(void) const {return has_time() ? _arena->time.month : 0;}
+        /// \brief Returns the day of month computed from the TIME line
+        int get_day(void) const {return has_time() ? _arena->time.day : 0;}
+        /// \brief Returns the hour of the TIME line
+        int get_hour(void) const {return has_time() ? _arena->time.hour : 0;}
+        /// \brief Returns the minute of the TIME line
+        int get_minute(void) const {return has_time() ? _arena->time.minute : 0;}
+        /// \brief Returns the seconds of the TIME line, including the fraction
+        double get_second(void) const {return has_time() ? _arena->time.second : 0.0;}
+        /// \brief Returns the time of the 42 simulation data point in seconds since J2000 (the ABSTIME), at full precision
+        double get_abs_time(void) const {return has_time() ? _arena->time.abs_time : 0.0;}
+
+        /// \brief Parses the numeric elements of the value for a key into a fixed size array, without allocating
+        /// @param key     The key to find
+        /// @param values  The array to parse into
+        /// @return        true if all N elements were parsed
+        template <size_t N>
+        bool get_array(std::string_view key, std::array<double, N>& values) const
+        {
+            return get_doubles(key, values.data(), N) == N;
+        }
+
+        /// \brief Parses the numeric elements of the value for a key into a caller provided buffer, without allocating
+        /// @param key     The key to find
+        /// @param values  The buffer to parse into
+        /// @param count   The number of elements the buffer holds
+        /// @return        The number of elements parsed (copied, for a field of a binary data point)
+        size_t get_doubles(std::string_view key, double *values, size_t count) const;
+
+        /// \brief Parses every numeric field of the 42 simulation data point in one pass
+        /// @param numeric  The fields and values, replaced; the keys are views valid while the data point is
+        void parse_numeric_fields(Sim42NumericFields& numeric) const;
         //@}
 
         /// @name Static Methods
         //@{
-        static void parse_double_vector(const std::string& text, std::vector<double>& dv);            
+        /** \brief Parses white space separated numbers, optionally in brackets, e.g. [1.0 2.0 3.0].
+         *
+         *  @param text  The text to parse
+         *  @param dv    The numbers, replaced
+         *  @throws      std::invalid_argument, with an error logged, if any of the text is not a number
+         */
+        static void parse_double_vector(const std::string& text, std::vector<double>& dv);
+
+        /** \brief Parses white space separated numbers, optionally in brackets, e.g. [1.0 2.0 3.0], without allocating.
+         *
+         *  @param text    The text to parse
+         *  @param values  The buffer to parse into
+         *  @param count   The most numbers to parse
+         *  @return        The number of numbers parsed, stopping at the first text that is not a number
+         */
+        static size_t parse_doubles(std::string_view text, double *values, size_t count);
+
         static void DOY2MD(long Year, long DayOfYear, long *Month, long *Day);
         static double DateToTime(long Year, long Month, long Day, long Hour, long Minute, double Second);
+
+        /** \brief Interpolates the numeric fields of two data points to a time between them.
+         *
+         *  Fields that are numeric in both data points with the same number of elements are interpolated
+         *  linearly, except 4 element fields whose last key part starts with q (e.g. SC[0].qn, SC[0].AC.qbn),
+         *  which are quaternions and are interpolated with SLERP.  Discrete fields (modes, flags, counts),
+         *  all other fields, and the TIME based date fields are taken from the earlier data point; ABSTIME
+         *  is set to the requested time.  A field is discrete if its key matches a pattern of discrete, or,
+         *  in a text frame, if 42 wrote it as an integer in both frames.  A binary frame carries no types,
+         *  so its discrete fields must be listed in discrete.
+         *
+         *  @param before    The data point at or before the requested time
+         *  @param after     The data point at or after the requested time
+         *  @param abs_time  The requested time, seconds since J2000
+         *  @param discrete  The keys of the discrete fields, NULL or empty for none beyond the integer text fields
+         *  @return          The interpolated data point
+         */
+        static Sim42DataPoint interpolate(const Sim42DataPoint& before, const Sim42DataPoint& after, double abs_time,
+            const Sim42KeyFilter *discrete = NULL);
         //@}
 
     private:
+        // Private helper methods
+        void parse_lines(bool lazy);
+        void parse_binary(void);
+        const char* binary_values(void) const {return _arena->text.data() + sizeof(Sim42BinaryTime);}
+        bool format_binary_value(std::string_view key, std::string_view& value) const;
+        void parse_time_value(std::string_view value);
+        bool find_value(std::string_view key, std::string_view& value) const;
+        bool find_lazy_value(std::string_view key, std::string_view& value) const;
+        void set_derived_value(std::string_view key, size_t offset, const std::string& value);
+        static const std::vector<std::string_view>& empty_lines(void);
+        static Sim42DataPoint interpolate_binary(const Sim42DataPoint& before, const Sim42DataPoint& after, double abs_time, double fraction,
+            const Sim42KeyFilter *discrete);
+
         // Private data
-        std::vector<std::string> _lines;
-        std::map<std::string, std::string> _key_values;
+        boost::shared_ptr<Sim42FrameArena> _arena;
     };
 
 }
@@ -0,0 +1,129 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42FRAMEARENA_HPP
+#define NOS3_SIM42FRAMEARENA_HPP
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sim_42schema.hpp>
+
+namespace Nos3
+{
+    /// \brief The time of a 42 frame, parsed from its TIME line
+    struct Sim42FrameTime
+    {
+        bool valid;         // false if the frame has no (well formed) TIME line
+        int year;
+        int doy;
+        int month;
+        int day;
+        int hour;
+        int minute;
+        double second;
+        double abs_time;    // seconds since J2000
+    };
+
+    /** \brief Storage for one 42 frame:  its text, and views of its lines, keys, and values into the text.
+     *
+     *  \details The TIME line is also parsed into time, once, so time is available without parsing text.
+     *  When lazy, key_values holds only the keys from the TIME line, and other keys are located in lines
+     *  on first access and remembered in found, which found_mutex protects since the arena is shared.
+     *  A binary frame (see Sim42BinaryHeader) has its payload in text and its fields described by
+     *  field_table; it is always lazy, with values formatted as text into formatted only when asked for.
+     *  The text is normally held in text, but can be held by an external owner (e.g. a mapped
+     *  frame log), in which case owner keeps it alive.  derived holds the values computed from the TIME
+     *  line.  Arenas are recycled by Sim42FrameArenaPool, keeping the capacity of every member, so a
+     *  steady stream of similar frames stops allocating after the first few.
+     */
+    struct Sim42FrameArena
+    {
+        typedef std::pair<std::string_view, std::string_view> KeyValue;
+
+        std::string text;                     // frame text, when held here
+        boost::shared_ptr<const void> owner;  // owner of the frame text, when held externally
+        std::string_view frame;               // the frame text, wherever it is held
+        std::vector<std::string_view> lines;  // lines of the frame, without new lines
+        std::vector<KeyValue> key_values;     // keys and values, sorted by key, first of duplicate keys first
+        Sim42FrameTime time;                  // the time parsed from the TIME line
+        char derived[128];                    // text of the MONTH, DAY, and ABSTIME values
+        bool lazy;                            // true if keys are located on first access rather than all at once
+        bool malformed;                       // true if the frame was rejected when parsed, so it holds no data
+        std::vector<KeyValue> found;          // when lazy, keys and values located so far, in order of first access
+        std::mutex found_mutex;               // protects found and formatted
+        boost::shared_ptr<const Sim42Schema> field_table;  // the fields of a binary frame, NULL for a text frame
+        std::deque<std::string> formatted;    // keys and values of a binary frame formatted as text so far
+
+        Sim42FrameArena() : lazy(false), malformed(false) {time.valid = false;}
+
+        /// \brief Empties the arena for reuse, keeping its capacity
+        void clear(void)
+        {
+            text.clear();
+            owner.reset();
+            frame = std::string_view();
+            lines.clear();
+            key_values.clear();
+            time.valid = false;
+            lazy = false;
+            malformed = false;
+            found.clear();
+            field_table.reset();
+            formatted.clear();
+        }
+    };
+
+    /** \brief Process wide pool of Sim42FrameArena, so frame storage is reused rather than reallocated.
+     *
+     *  \details acquire() returns an empty arena that goes back to the pool when its last reference is
+     *  released.  At most MAX_POOLED arenas are kept; more are freed.
+     */
+    class Sim42FrameArenaPool
+    {
+    public:
+        /// Pool is implemented as a Singleton
+        static Sim42FrameArenaPool& Instance();
+
+        /// \brief Returns an empty arena, recycled if one is available
+        boost::shared_ptr<Sim42FrameArena> acquire(void);
+
+        static const size_t MAX_POOLED = 64;
+
+    private:
+        Sim42FrameArenaPool() {}
+
+        // Disable copying and assignment
+        Sim42FrameArenaPool(const Sim42FrameArenaPool& other);
+        Sim42FrameArenaPool& operator=(const Sim42FrameArenaPool& other);
+
+        // Private helper methods
+        void release(Sim42FrameArena *arena);
+
+        // Private data
+        std::mutex _mutex;  // protects _free
+        std::vector<Sim42FrameArena*> _free;
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42FRAMEREADER_HPP
+#define NOS3_SIM42FRAMEREADER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sim_42key_filter.hpp>
+
+namespace Nos3
+{
+    /** \brief Class for reading 42 telemetry frames from a socket.
+     *
+     *  \details Data is pulled from the socket with large recv calls into a receive
+     *  buffer that is reused from frame to frame.  Lines are split on the new line
+     *  character in place in the buffer, and a frame ends with the line that starts
+     *  with [ENDMSG].  A line that does not fit in the buffer grows the buffer, so
+     *  there is no limit on line length.  Binary streams are read the same way, a
+     *  message at a time.  Lines a key filter does not select are skipped in the
+     *  buffer, never copied into the frame.  Byte and frame rates are computed over
+     *  a window of about one second.
+     */
+    class Sim42FrameReader
+    {
+    public:
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking the initial size of the receive buffer.
+        /// @param  initial_capacity  The initial size of the receive buffer in bytes
+        Sim42FrameReader(size_t initial_capacity = 65536);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Attaches the reader to a connected socket and discards any buffered data.
+        /// @param  socket_fd  The connected socket to read from
+        void reset(int socket_fd);
+
+        /** \brief Reads the next complete frame from the socket.
+         *
+         *  @param  frame    The text of the frame, each line ending in a new line, including the [ENDMSG] line.
+         *                   Its capacity is reused, so passing the same (or a recycled) string avoids allocating.
+         *  @param  filter   The lines to keep, or NULL to keep every line.  The [ENDMSG] line is always kept.
+         *  @returns         true if a complete frame was read, false if the socket was closed or an error occurred.
+         */
+        bool read_frame(std::string& frame, const Sim42KeyFilter *filter = NULL);
+
+        /** \brief Reads the next complete message of a binary 42 stream (see Sim42BinaryHeader) from the socket.
+         *
+         *  @param  payload  The payload of the message, without its header.  Its capacity is reused.
+         *  @param  type     The type of the message
+         *  @returns         true if a complete message was read, false if the socket was closed, an error occurred,
+         *                   or the stream is not a binary 42 stream.
+         */
+        bool read_message(std::string& payload, uint32_t& type);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the total number of bytes received since the last reset
+        uint64_t get_total_bytes(void) const {return _total_bytes;}
+        /// \brief Returns the total number of frames received since the last reset
+        uint64_t get_total_frames(void) const {return _total_frames;}
+        /// \brief Returns the bytes per second received over the last complete rate window
+        double get_bytes_per_second(void) const {return _bytes_per_second.load();}
+        /// \brief Returns the frames per second received over the last complete rate window
+        double get_frames_per_second(void) const {return _frames_per_second.load();}
+        //@}
+
+    private:
+        // Private helper methods
+        bool fill_buffer(void);
+        void update_rates(void);
+
+        // Private data
+        int _socket_fd;
+        std::vector<char> _buffer;
+        size_t _head; // start of unconsumed data
+        size_t _tail; // one past the end of received data
+
+        // ... statistics
+        std::atomic<uint64_t> _total_bytes;
+        std::atomic<uint64_t> _total_frames;
+        uint64_t _window_bytes;
+        uint64_t _window_frames;
+        std::chrono::steady_clock::time_point _window_start;
+        std::atomic<double> _bytes_per_second;
+        std::atomic<double> _frames_per_second;
+    };
+}
+
+#endif
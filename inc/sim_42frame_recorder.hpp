@@ -0,0 +1,114 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42FRAMERECORDER_HPP
+#define NOS3_SIM42FRAMERECORDER_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <sim_42data_point.hpp>
+
+namespace Nos3
+{
+    /// \brief Header at the start of a 42 frame log file
+    struct Sim42FrameLogHeader
+    {
+        char     magic[8];     // SIM42LOG_MAGIC
+        uint32_t version;      // SIM42LOG_VERSION
+        uint32_t header_size;  // sizeof(Sim42FrameLogHeader), records start here
+    };
+
+    /// \brief Header of each record of a 42 frame log file, followed by the frame text, padded to 8 bytes
+    struct Sim42FrameLogRecord
+    {
+        uint32_t length;            // bytes of frame text, lines each end with a new line
+        uint32_t reserved;
+        int64_t  receive_time_ns;   // steady clock time the frame was received
+        double   abs_time;          // 42 ABSTIME of the frame, seconds since J2000
+    };
+
+    static const char SIM42LOG_MAGIC[8] = {'N', 'O', 'S', '3', '4', '2', 'L', 'G'};
+    static const uint32_t SIM42LOG_VERSION = 1;
+
+    /** \brief Class for recording 42 frames to a memory mapped binary log.
+     *
+     *  \details Each frame is appended as a Sim42FrameLogRecord and the frame text.  The file grows in
+     *  chunks that are mapped into memory, so recording a frame is a memcpy rather than a write call.
+     *  The file is truncated to the recorded length when the recorder is destroyed.  Logs are replayed
+     *  by SimData42ReplayProvider.  A file can have one recorder at a time in a process; a second
+     *  recorder for the same file logs an error and records nothing, rather than corrupting the log.
+     */
+    class Sim42FrameRecorder
+    {
+    public:
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking the file to record to.  An existing file is replaced, unless another recorder has it open.
+        /// @param  filename  The name of the log file
+        Sim42FrameRecorder(const std::string& filename);
+        /// \brief Destructor.  Unmaps, truncates, and closes the log file.
+        ~Sim42FrameRecorder(void);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Appends a frame to the log.
+        /// @param  dp  The data point of the frame
+        void record(const Sim42DataPoint& dp);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the name of the log file
+        const std::string& get_filename(void) const {return _filename;}
+        /// \brief Returns true if the log file is open and mapped
+        bool is_open(void) const {return _data != NULL;}
+        /// \brief Returns the number of frames recorded
+        uint64_t get_frame_count(void) const {return _frame_count;}
+        //@}
+
+        static const size_t CHUNK_SIZE = 16*1024*1024;
+
+    private:
+        // Disable copying and assignment
+        Sim42FrameRecorder(const Sim42FrameRecorder& other);
+        Sim42FrameRecorder& operator=(const Sim42FrameRecorder& other);
+
+        // Private helper methods
+        bool map(size_t capacity);
+        static bool claim(const std::string& filename, std::string& path);
+
+        // Private static data
+        static std::mutex _paths_mutex;        // protects _paths
+        static std::set<std::string> _paths;   // the files open for recording, by absolute path
+
+        // Private data
+        std::string _filename;
+        std::string _path;  // the claimed absolute path of the file, empty if not claimed
+        int _fd;
+        char *_data;
+        size_t _capacity;
+        size_t _used;
+        uint64_t _frame_count;
+        std::mutex _mutex;  // protects all data above
+    };
+}
+
+#endif
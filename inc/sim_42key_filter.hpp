@@ -0,0 +1,78 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42KEYFILTER_HPP
+#define NOS3_SIM42KEYFILTER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace Nos3
+{
+    /** \brief Class to select the lines of a 42 frame by key, so lines nobody reads can be skipped unparsed.
+     *
+     *  \details A pattern matches the start of a key, e.g. SC[1].AC. matches every key of the attitude
+     *  control of spacecraft 1.  A * in a pattern matches any run of characters within the key, e.g.
+     *  SC[*].PosN matches the position of every spacecraft; a trailing * changes nothing.  Lines are
+     *  matched raw, before trimming or splitting at the =.  The TIME line always matches, so data points
+     *  always have a time.  An empty filter (no patterns) matches every line.
+     */
+    class Sim42KeyFilter
+    {
+    public:
+        /// @name Constructors
+        //@{
+        /// \brief Default constructor, for an empty filter that matches every line
+        Sim42KeyFilter() {}
+        /// \brief Constructor from a configuration tree of pattern elements, e.g. <pattern>SC[1].AC.</pattern>
+        Sim42KeyFilter(const boost::property_tree::ptree& filter);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Adds a pattern, unless the filter already has it
+        void add_pattern(const std::string& pattern);
+        /// \brief Adds every pattern of another filter, so this filter matches the lines either one matches
+        void add_patterns(const Sim42KeyFilter& other);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns true if the filter has no patterns, and so matches every line
+        bool empty(void) const {return _patterns.empty();}
+        /// \brief Returns true if the line of a 42 frame (without its new line) is selected
+        bool matches(const char *line, size_t length) const;
+        //@}
+
+    private:
+        // Private helper methods
+        static bool match_wildcards(const std::string& pattern, const char *key, size_t length);
+
+        // Private data
+        struct Pattern
+        {
+            std::string text;
+            bool has_wildcard;
+        };
+        std::vector<Pattern> _patterns;
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42SCHEMA_HPP
+#define NOS3_SIM42SCHEMA_HPP
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace Nos3
+{
+    /// \brief Handle to a numeric field of a Sim42Schema; the field occupies size doubles starting at offset.
+    struct Sim42FieldHandle
+    {
+        uint32_t offset;
+        uint32_t size;
+        /// \brief Returns true if the handle refers to a field of a schema
+        bool is_valid(void) const {return size > 0;}
+    };
+
+    /** \brief Class describing the numeric 42 fields a typed data point holds.
+     *
+     *  \details Each key (e.g. SC[0].PosN or SC[0].AC.svb) is compiled once into a slot range of a flat array
+     *  of doubles.  Parsing a frame looks each line's key up in the schema and writes its numbers straight into
+     *  the array, so consumers read fields through a precomputed Sim42FieldHandle with no string lookups.
+     *  The schema must be complete before frames are parsed with it.
+     */
+    class Sim42Schema
+    {
+    public:
+        /// @name Constructors
+        //@{
+        /// \brief Default constructor, an empty schema.
+        Sim42Schema() : _value_count(0) {}
+        /** \brief Constructor from configuration.
+         *
+         *  Reads the field children of the schema node, e.g.
+         *  <schema><field><key>SC[0].PosN</key><size>3</size></field></schema>.  The size defaults to 1.
+         *  @param schema  The schema node of the configuration
+         */
+        Sim42Schema(const boost::property_tree::ptree& schema);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Adds a field to the schema, or returns the handle of an existing field with the same key.
+        /// @param key   The 42 key of the field
+        /// @param size  The number of numeric elements in the field
+        /// @return      The handle of the field, or an invalid handle if size is 0
+        Sim42FieldHandle add_field(const std::string& key, uint32_t size);
+
+        /// \brief Adds the fields of the payload of a binary field table message (see Sim42BinaryHeader), in order.
+        /// @param table   The payload
+        /// @param length  The bytes of payload
+        /// @return        false if the payload is malformed, in which case some fields may have been added
+        bool add_binary_field_table(const char *table, size_t length);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the handle of a field, or an invalid handle if the key is not in the schema
+        Sim42FieldHandle get_handle(std::string_view key) const;
+        /// \brief Returns the total number of doubles of all fields
+        uint32_t get_value_count(void) const {return _value_count;}
+        /// \brief Returns true if the schema has no fields
+        bool empty(void) const {return _value_count == 0;}
+        /// \brief Returns the keys of the fields, in the order they were added
+        const std::deque<std::string>& get_keys(void) const {return _keys;}
+
+        /** \brief Parses the numeric fields of the schema from the lines of a 42 frame.
+         *
+         *  Elements of fields missing from the frame, or with fewer numbers than the field size, are set to NaN.
+         *  @param lines   The lines of the 42 frame
+         *  @param values  The flat array of get_value_count() doubles to fill
+         */
+        void parse(const std::vector<std::string_view>& lines, double *values) const;
+        //@}
+
+    private:
+        // Disable copying and assignment, _fields refers to the text in _keys
+        Sim42Schema(const Sim42Schema& other);
+        Sim42Schema& operator=(const Sim42Schema& other);
+
+        // Private data
+        std::deque<std::string> _keys;  // owns the key text; a deque never moves its elements
+        std::unordered_map<std::string_view, Sim42FieldHandle> _fields;
+        uint32_t _value_count;
+    };
+}
+
+#endif
@@ -0,0 +1,80 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42TYPEDDATAPOINT_HPP
+#define NOS3_SIM42TYPEDDATAPOINT_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sim_i_data_point.hpp>
+#include <sim_42schema.hpp>
+
+namespace Nos3
+{
+    class Sim42DataPoint;
+
+    /** \brief Class to contain the numeric fields of an entry of 42 simulation data, laid out by a Sim42Schema.
+     *
+     */
+    class Sim42TypedDataPoint : public SimIDataPoint
+    {
+    public:
+        /// @name Constructors
+        //@{
+        /** \brief Constructor from a schema and the lines of a 42 frame.
+         *  Parses the schema fields from the lines.
+         */
+        Sim42TypedDataPoint(const Sim42Schema& schema, const std::vector<std::string_view>& lines) : _values(schema.get_value_count())
+        {
+            schema.parse(lines, _values.data());
+        }
+        /** \brief Constructor from a schema and a data point, text or binary.
+         *  Parses the schema fields from the lines, or copies them from the binary frame.
+         */
+        Sim42TypedDataPoint(const Sim42Schema& schema, const Sim42DataPoint& dp);
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the elements of a field
+        /// @param handle  The handle of the field from the schema
+        /// @return        A pointer to the handle.size elements of the field
+        const double* get(const Sim42FieldHandle& handle) const {return _values.data() + handle.offset;}
+
+        /// \brief Returns one element of a field
+        /// @param handle  The handle of the field from the schema
+        /// @param index   The element of the field
+        /// @return        The element value, NaN if the field was not in the frame
+        double get(const Sim42FieldHandle& handle, uint32_t index) const {return _values[handle.offset + index];}
+
+        /// \brief Returns the flat array of all field values
+        const std::vector<double>& get_values(void) const {return _values;}
+
+        /// \brief Returns a string representation of the typed data point
+        std::string to_string(void) const;
+        //@}
+
+    private:
+        // Private data
+        std::vector<double> _values;
+    };
+
+}
+
+#endif
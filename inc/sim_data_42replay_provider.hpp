@@ -0,0 +1,74 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIMDATA42REPLAYPROVIDER_HPP
+#define NOS3_SIMDATA42REPLAYPROVIDER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <sim_42frame_recorder.hpp>
+#include <sim_data_42socket_provider.hpp>
+
+namespace Nos3
+{
+    /** \brief Class for a provider of simulation data that replays a 42 frame log recorded by Sim42FrameRecorder.
+     *
+     *  The log is mapped read only and frames are parsed straight from the mapping on a replay thread,
+     *  without copying (the data points view the mapping, and keep it mapped while they exist), then
+     *  published exactly as SimData42SocketProvider publishes frames read from 42, so history, typed data
+     *  points, and the other 42 features work the same.  The time-scale configuration value sets the
+     *  pace:  1 replays at the recorded rate, 2 at twice the recorded rate, and 0 as fast as possible.
+     *  With loop set the log is replayed from the start each time it ends.  A replay sends no commands
+     *  and records nothing, even if command-port or record-file is configured.
+     */
+    class SimData42ReplayProvider : public SimData42SocketProvider
+    {
+    public:
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking a configuration object.
+        /// @param  sc  The configuration for the simulation
+        SimData42ReplayProvider(const boost::property_tree::ptree& config);
+        ~SimData42ReplayProvider(void);
+        //@}
+
+    private:
+        // Private helper methods
+        void replay(void);
+        bool wait_until(std::chrono::steady_clock::time_point time);
+
+        // Private data
+        std::string _replay_file;
+        double _time_scale;
+        bool _loop;
+        boost::interprocess::file_mapping _file;
+        boost::shared_ptr<boost::interprocess::mapped_region> _region;  // shared with the data points that view it
+
+        // ... replay thread / thread state data
+        std::thread *_replay_thread;
+        bool _not_terminating;
+        std::mutex _replay_mutex;  // protects _not_terminating
+        std::condition_variable _replay_cv;
+    };
+}
+
+#endif
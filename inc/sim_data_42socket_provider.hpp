@@ -18,24 +18,34 @@
 #ifndef NOS3_SIMDATA42SOCKETPROVIDER_HPP
 #define NOS3_SIMDATA42SOCKETPROVIDER_HPP
 
-#include <thread>
+#include <atomic>
 #include <mutex>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
 #include <sim_i_data_provider.hpp>
+#include <sim_42command_writer.hpp>
+#include <sim_42connection.hpp>
 #include <sim_42data_point.hpp>
+#include <sim_42key_filter.hpp>
+#include <sim_42schema.hpp>
+#include <sim_42typed_data_point.hpp>
 
 namespace Nos3
 {
     /** \brief Class for a provider of simulation data that provides data from a 42 socket connection.
      *
-     *  This class can concretely retrieve data from a 42 socket... but is still virtual because it is up
-     *  to a derived class to determine what 42 data it should be a provider of... the get_data_point()
-     *  method is still pure virtual.  Now it does need its derived class to perform
+     *  This class concretely retrieves data from a 42 socket, and get_data_point() returns the most recent
+     *  frame, but it is up to a derived class to determine what 42 data it should be a provider of (and it
+     *  may override get_data_point() to do so).  It does need its derived class to perform
      *  connect_reader_thread_as_42_socket_client(), otherwise the 42 data point will never be
      *  set with any valid data... this allows the derived class to specify the endpoint
      *  information, but places all the shared code for reading 42 data in this class.
+     *  Telemetry connections are shared through Sim42ConnectionManager, so all providers in a
+     *  process that read the same 42 endpoint share one socket, reader thread, and frame parse.
+     *  Telemetry and command sockets connect, and reconnect after a disconnect, in the background;
+     *  until the first frame arrives get_data_point() returns an empty data point and has_data() is false.
      */
     class SimData42SocketProvider : public SimIDataProvider
     {
@@ -51,28 +61,91 @@ namespace Nos3
         /// @name Non-mutating public worker methods
         //@{
         /** \brief Method to retrieve simulation data.
+         *
+         *  The data point returned is the immutable snapshot of the most recent 42 frame, shared with the
+         *  reader and any other caller, so it is returned without locking or copying and must not be modified.
          *
          * @returns                     A data point of simulation data.
          */
         virtual boost::shared_ptr<SimIDataPoint> get_data_point(void) const
         {
-            boost::shared_ptr<Sim42DataPoint> dp;
-            {
-                std::lock_guard<std::mutex> lock(_data_point_mutex);
-                dp = boost::shared_ptr<Sim42DataPoint>(new Sim42DataPoint(_data_point));
-                // Lock is released when scope ends
-            }
-            return dp;
+            return boost::atomic_load(&_data_point);
+        }
+
+        /** \brief Method to find out if any 42 data has been received yet.
+         *
+         * @returns                     true once the first frame has been received.
+         */
+        bool has_data(void) const {return _has_data;}
+
+        /** \brief Method to retrieve simulation data sampled at a given time.
+         *
+         *  The data point is interpolated between the two frames of the history that bracket the time (see
+         *  Sim42DataPoint::interpolate), except the fields whose keys match the discrete-keys patterns, which
+         *  are taken from the earlier frame.  Times outside the history get the oldest or newest frame.  The
+         *  history is off by default; with no history (history-depth of 0) this is the same as get_data_point().
+         *
+         * @param       abs_time    The time to sample, seconds since J2000 (the 42 ABSTIME).
+         * @returns                 A data point of simulation data.
+         */
+        boost::shared_ptr<SimIDataPoint> get_data_point_at(double abs_time) const;
+
+        /** \brief Method to retrieve the typed numeric fields of the most recent 42 frame.
+         *
+         *  The fields are those of the schema from the data-provider schema configuration node and
+         *  add_schema_field().  Read them with the handles from get_field_handle().
+         *
+         * @returns                     A typed data point of simulation data.
+         */
+        boost::shared_ptr<const Sim42TypedDataPoint> get_typed_data_point(void) const
+        {
+            return boost::atomic_load(&_typed_data_point);
         }
 
+        /** \brief Method to look up the handle of a typed field, once, before reading typed data points.
+         *
+         * @param       key        The 42 key of the field.
+         * @returns                The handle of the field, invalid if the key is not in the schema.
+         */
+        Sim42FieldHandle get_field_handle(const std::string& key) const {return _schema.get_handle(key);}
+
         /** \brief Method to send a simulation command to 42.
+         *
+         *  The command is queued and written by a background writer, coalesced with any other commands
+         *  queued before the writer gets to it, or within command-batch-window-us of the first, so this does
+         *  not block on the socket.  Commands queued before the command socket connects are written once it
+         *  does.  The command is dropped, with an error logged, if there is no command port, or the queue
+         *  stays full for command-queue-timeout-ms.
          *
          * @param       message    Text command message to send.
          */
         void send_command_to_socket(const std::string& message);
+
+        /** \brief Method to retrieve the statistics of the commands sent to 42.
+         *
+         * @returns                     The queue depth, coalescing, and latency statistics, all zero if there is no command port.
+         */
+        Sim42CommandWriterStats get_command_stats(void) const
+        {
+            return _command_writer ? _command_writer->get_stats() : Sim42CommandWriterStats();
+        }
+
+        /** \brief Method to retrieve the statistics of reading and parsing 42 telemetry frames.
+         *
+         * @returns                     The queue depth and frames read, parsed, and dropped, all zero if not subscribed.
+         */
+        Sim42PipelineStats get_telemetry_stats(void) const;
         //@}
 
     protected:
+        /// @name Protected constructors
+        //@{
+        /// \brief Constructor taking a configuration object, for a provider that replays frames rather than reading 42.
+        /// @param  sc         The configuration for the simulation
+        /// @param  replaying  true to connect no command socket and record nothing, whatever the configuration
+        SimData42SocketProvider(const boost::property_tree::ptree& config, bool replaying);
+        //@}
+
         /// @name Mutating protected worker methods
         //@{
         /** \brief Method to connect to a 42 socket and start reading data
@@ -82,36 +155,80 @@ namespace Nos3
          */
         void connect_reader_thread_as_42_socket_client(std::string server_host, uint16_t server_port);
 
+        /** \brief Method to add a field to the typed data point schema.  Must be called before connecting the reader.
+         *
+         * @param       key        The 42 key of the field, e.g. SC[0].PosN.
+         * @param       size       The number of numeric elements of the field.
+         * @returns                The handle of the field.
+         */
+        Sim42FieldHandle add_schema_field(const std::string& key, uint32_t size) {return _schema.add_field(key, size);}
+
+        /** \brief Method to select the keys this provider reads, in addition to any in the key-filter config.  Must be called before connecting the reader.
+         *
+         *  With no patterns every key is read.  With patterns, lines no pattern matches (other than the TIME line) are
+         *  skipped as frames are read, unless another provider sharing the connection reads them.  The schema keys are
+         *  always read.
+         *
+         * @param       pattern    A key prefix, e.g. SC[1].AC., optionally with * wildcards, e.g. SC[*].PosN.
+         */
+        void add_key_filter_pattern(const std::string& pattern) {_key_filter->add_pattern(pattern);}
+
+        /** \brief Method to publish a new frame of 42 data, called for each frame read from the socket.
+         *
+         * @param       dp         The data point of the frame, which must not be modified after this call.
+         */
+        void receive_frame(const boost::shared_ptr<Sim42DataPoint>& dp);
+        //@}
+
+        /// @name Protected accessors
+        //@{
+        /// \brief Returns true if frames should be parsed lazily, keys located on first access (lazy-parsing config)
+        bool is_lazy_parsing(void) const {return _lazy_parsing;}
+        //@}
+
     private:
         // Private helper methods
-        void connect_command_socket_as_42_socket_client(void);
-        bool connect_as_42_socket_client(std::string a_42_host, uint16_t a_42_port, int &socket_fd);
-        void telemetry_socket_reader(void);
-        void read_telemetry_socket_data(std::vector<std::string>& message);
-        static char rgetc(int fd);
-        static char *rgets(char *s, int n, int fd);
+        void add_to_history(const boost::shared_ptr<Sim42DataPoint>& dp);
 
         // Private data
         // ... connection data
         std::string _server_host;
-        std::string _server_telemetry_port;
         uint16_t _server_command_port;
         int _max_connection_attempts;
         int _retry_wait_seconds;
-        int _telemetry_socket_fd;
-        int _command_socket_fd;
         double _absolute_start_time;
+        bool _lazy_parsing;
+        std::string _record_file;  // the log the shared connection records to, empty for none
+        Sim42PipelineOptions _pipeline;
+
+        // ... telemetry subscription to the shared connection (0 if none)
+        uint64_t _telemetry_subscription;
+
+        // ... command writer, connects in the background and writes queued commands (NULL if no command port)
+        boost::shared_ptr<Sim42CommandWriter> _command_writer;
 
-        // ... telemetry reader thread / thread state data
-        std::thread *_telemetry_socket_client_thread;
-        bool _not_terminating; // Used to signal the thread when we are terminating so the telemetry reader thread quits reading the socket
+        // ... the latest data point read from the socket, replaced (never modified) with boost::atomic_store
+        boost::shared_ptr<Sim42DataPoint> _data_point;
+        std::atomic<bool> _has_data;
 
-        // ... command state data
-        bool _command_port_connected;
+        // ... the keys this provider reads, empty for every key
+        boost::shared_ptr<Sim42KeyFilter> _key_filter;
 
-        // ... a data point of data read from the socket
-        Sim42DataPoint _data_point;
-        mutable std::mutex _data_point_mutex;  // protects _data_point
+        // ... the typed fields of the latest data point, laid out by _schema, replaced with boost::atomic_store
+        Sim42Schema _schema;
+        boost::shared_ptr<Sim42TypedDataPoint> _typed_data_point;
+
+        // ... a bounded ring of recent data points and their ABSTIME, oldest at _history_next when full
+        struct HistoryEntry
+        {
+            double abs_time;
+            boost::shared_ptr<Sim42DataPoint> data_point;
+        };
+        std::vector<HistoryEntry> _history;
+        size_t _history_depth;
+        size_t _history_next;
+        mutable std::mutex _history_mutex;  // protects _history and _history_next
+        Sim42KeyFilter _discrete_keys;      // the keys get_data_point_at does not interpolate
 
     };
 }
@@ -18,6 +18,10 @@
 #ifndef NOS3_SIMDATASHMEMPROVIDER_HPP
 #define NOS3_SIMDATASHMEMPROVIDER_HPP
 
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 #include <boost/property_tree/ptree.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/shared_ptr.hpp>
@@ -26,6 +30,7 @@
 #include <sim_i_data_provider.hpp>
 #include <sim_shmem_data_point.hpp>
 
+#include <actuator_data.hpp>
 #include <blackboard_data.hpp>
 
 namespace Nos3
@@ -33,6 +38,28 @@ namespace Nos3
     namespace bip = boost::interprocess;
 
     /** \brief Class for a provider of simulation data that provides data from a shared memory connection.
+     *
+     *  Once something subscribes or waits for new data, a watcher thread blocks until the blackboard is published
+     *  (see blackboard_wait) and notifies subscribers.  Until the writer is seen to use the blackboard seqlock it
+     *  also polls the blackboard AbsTime every shared-memory-poll-us microseconds, for writers that predate it.
+     *
+     *  Data points are consistent snapshots of the blackboard, copied under its seqlock (see BlackboardSlot).
+     *
+     *  By default the segment holds one spacecraft.  With shared-memory-slots set it holds that many (see
+     *  BlackboardSegmentHeader), so a constellation shares one mapping, and the simulator reads slot
+     *  shared-memory-slot.  With shared-memory-history set as well, each slot also keeps that many of its last
+     *  publishes (see BlackboardHistoryRecord), so a model can see every step the writer published.
+     *
+     *  With shared-memory-fields set to some of the BlackboardData field names (e.g. "STValid STqn"), reads copy
+     *  only the cache lines that hold those fields (see BlackboardFieldMask) and leave the rest of the data zero.
+     *
+     *  To keep page faults and TLB misses off the tick path, shared-memory-huge-pages can be "transparent" (ask
+     *  for transparent huge pages) or "hugetlbfs" (map a file of the segment name in shared-memory-hugetlbfs-dir,
+     *  a hugetlbfs mount, instead of a POSIX shared memory object); shared-memory-lock locks the segments in
+     *  memory, and shared-memory-prefault faults them in at construction.
+     *
+     *  With actuator-memory-name set, hardware models command 42 the other way through an actuator segment
+     *  of the same slots (see ActuatorSlot) with send_actuator_command, rather than over a command socket.
      */
 
     class SimDataShmemProvider : public SimIDataProvider
@@ -43,7 +70,7 @@ namespace Nos3
         /// \brief Constructor taking a configuration object.
         /// @param  sc  The configuration for the simulation
         SimDataShmemProvider(const boost::property_tree::ptree& config);
-        ~SimDataShmemProvider(void) {}
+        ~SimDataShmemProvider(void);
         //@}
 
         /// @name Non-mutating public worker methods
@@ -54,21 +81,142 @@ namespace Nos3
          */
         virtual boost::shared_ptr<SimIDataPoint> get_data_point(void) const
         {
-            boost::shared_ptr<SimShmemDataPoint> dp;
-            {
-                dp = boost::shared_ptr<SimShmemDataPoint>(
-                    new SimShmemDataPoint(_blackboard_data->svb, _blackboard_data->bvb, _blackboard_data->Hvb, 
-                                          _blackboard_data->GyroRate, _blackboard_data->CSSValid, _blackboard_data->CSSIllum, 
-                                          _blackboard_data->FSSValid, _blackboard_data->FSSSunAng, _blackboard_data->STValid,
-                                          _blackboard_data->STqn, _blackboard_data->GPSPosN, _blackboard_data->GPSVelN, 
-                                          _blackboard_data->AccelAcc, _blackboard_data->WhlH));
-            }
+            boost::shared_ptr<SimShmemDataPoint> dp(new SimShmemDataPoint());
+            blackboard_read(*_blackboard, _field_mask, dp->get_data());
             return dp;
         }
 
+        /** \brief Copies the blackboard fields of shared-memory-fields (every field by default) into a caller owned snapshot, without allocating.
+         *
+         *  The copy is one memcpy of the blackboard (or of the cache lines of the fields) under its seqlock, so
+         *  the snapshot is consistent.  Reuse one snapshot from read to read on the fast path rather than get_data_point.
+         *  @param snapshot  The snapshot to fill
+         */
+        void read_snapshot(BlackboardSnapshot& snapshot) const
+        {
+            snapshot.sequence = blackboard_read(*_blackboard, _field_mask, snapshot.data);
+        }
+
+        /** \brief Copies some blackboard fields into a caller owned snapshot, without allocating.
+         *
+         *  @param snapshot  The snapshot to fill; the fields not in the mask are left as they were
+         *  @param mask      The fields to copy, resolved once with blackboard_resolve_mask
+         */
+        void read_snapshot(BlackboardSnapshot& snapshot, const BlackboardFieldMask& mask) const
+        {
+            snapshot.sequence = blackboard_read(*_blackboard, mask, snapshot.data);
+        }
+
+        /// \brief Returns the fields reads copy, from shared-memory-fields
+        const BlackboardFieldMask& get_field_mask(void) const {return _field_mask;}
+
+        /** \brief Copies the blackboard into a snapshot only if it has been published since the snapshot was taken.
+         *
+         *  Cheap when nothing changed:  one load of the blackboard sequence.  Relies on the writer using the
+         *  blackboard seqlock; start with read_snapshot.
+         *  @param snapshot  The snapshot to refresh
+         *  @return          true if the snapshot was refreshed
+         */
+        bool read_snapshot_if_changed(BlackboardSnapshot& snapshot) const
+        {
+            if (_blackboard->sequence.load(std::memory_order_acquire) == snapshot.sequence) return false;
+            read_snapshot(snapshot);
+            return true;
+        }
+
+        /** \brief Blocks until the blackboard is published after a snapshot was taken, then refreshes the snapshot.
+         *
+         *  @param snapshot  The snapshot to refresh; start with read_snapshot
+         *  @param timeout   The longest time to wait
+         *  @return          true if the snapshot was refreshed, false if the wait timed out or the provider is being destroyed
+         */
+        bool wait_for_snapshot(BlackboardSnapshot& snapshot, std::chrono::microseconds timeout) const
+        {
+            if (!blackboard_wait(*_blackboard, snapshot.sequence, timeout)) return false;
+            read_snapshot(snapshot);
+            return true;
+        }
+
+        /// \brief Returns the generation of the blackboard, the number of times it has been published
+        uint32_t get_generation(void) const {return blackboard_generation(*_blackboard);}
+
+        /// \brief Returns true if there is an actuator segment to send actuator commands to
+        bool has_actuators(void) const {return _actuators != NULL;}
+
+        /// \brief Returns the publishes kept in the history of the blackboard, 0 if it has none
+        uint32_t get_history_depth(void) const {return _history_depth;}
+
+        /** \brief Copies the latest publish at or before a time from the history of the blackboard.
+         *
+         *  @param abs_time  The time, seconds since J2000 (AbsTime)
+         *  @param snapshot  The copy of the publish
+         *  @return          false if there is no history or every publish still in it is after the time
+         */
+        bool read_history_at(double abs_time, BlackboardSnapshot& snapshot) const
+        {
+            return _history != NULL && blackboard_history_at(*_blackboard, _history, _history_depth, abs_time, snapshot);
+        }
+
+        /** \brief Copies the publishes after a generation from the history of the blackboard, oldest first.
+         *
+         *  @param generation  The generation already seen, e.g. the sequence of the last snapshot copied / 2
+         *  @param snapshots   The copies of the publishes
+         *  @param count       The most publishes to copy
+         *  @return            The publishes copied; those that have already left the history are skipped
+         */
+        uint32_t read_history_since(uint32_t generation, BlackboardSnapshot* snapshots, uint32_t count) const
+        {
+            return blackboard_history_since(*_blackboard, _history, _history_depth, generation, snapshots, count);
+        }
+        //@}
+
+        /// @name Mutating public worker methods
+        //@{
+        /** \brief Method to send an actuator command to 42 through the actuator segment.
+         *
+         *  The command is written under the seqlock of the actuator's channel, so only one hardware model may
+         *  command each actuator.
+         *
+         * @param       type       The kind of actuator.
+         * @param       index      The index of the actuator of its kind, e.g. the wheel number.
+         * @param       abs_time   The time the command is for, seconds since J2000.
+         * @param       command    The command, in the units of the kind of actuator (see ActuatorType).
+         * @returns                false, with an error logged, if there is no actuator segment or no such actuator.
+         */
+        bool send_actuator_command(ActuatorType type, uint32_t index, double abs_time, double command);
+        //@}
+
+    protected:
+        /// @name Protected subscription methods
+        //@{
+        /// \brief Starts the watcher thread that notifies subscribers of new blackboard data.
+        virtual void start_notifications(void);
+        //@}
+
     private:
+        // Private helper methods
+        void watch_blackboard(void);
+        bip::mapped_region map_segment(const std::string& name, size_t size) const;
+        void prefault(const bip::mapped_region& region) const;
+
+        // Private data
+        std::string        _huge_pages;     // "none", "transparent", or "hugetlbfs"
+        std::string        _hugetlbfs_dir;
+        bool               _lock_memory;
+        bool               _prefault;
         bip::mapped_region _shm_region;
-        BlackboardData*    _blackboard_data;
+        BlackboardSlot*    _blackboard;  // the slot of this simulator's spacecraft
+        const BlackboardHistoryRecord* _history;
+        uint32_t           _history_depth;
+        BlackboardFieldMask _field_mask;
+        bip::mapped_region _actuator_region;
+        ActuatorSlot*      _actuators;  // the actuator slot of this simulator's spacecraft, NULL for none
+
+        // ... watcher thread / thread state data
+        std::chrono::microseconds _poll_interval;
+        std::thread *_watcher_thread;
+        bool _watcher_terminating;
+        std::mutex _watcher_mutex;  // protects _watcher_terminating
     };
 }
 
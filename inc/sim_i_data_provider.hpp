@@ -18,6 +18,18 @@
 #ifndef NOS3_SIMIDATAPROVIDER_HPP
 #define NOS3_SIMIDATAPROVIDER_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
 #include <sim_data_provider_maker.hpp>
 #define REGISTER_DATA_PROVIDER(T,K) static Nos3::SimDataProviderMaker<T> maker(K) // T = type, K = key
 
@@ -26,15 +38,25 @@
 
 namespace Nos3
 {
-    /// \brief Interface for a provider of simulation data.
+    /** \brief Interface for a provider of simulation data.
+     *
+     *  \details Data can be pulled with get_data_point(), or pushed:  subscribe() registers a callback
+     *  called with each new data point, and wait_for_next() blocks until a new data point arrives.
+     *  Derived classes call notify_subscribers() when new data lands; a derived class that has to watch
+     *  for new data can override start_notifications() to start watching only once someone is listening.
+     */
     class SimIDataProvider
     {
     public:
+        /// \brief Type of the callback called with each new data point
+        typedef std::function<void(const boost::shared_ptr<SimIDataPoint>&)> DataPointCallback;
+
         /// @name Constructors / destructors
         //@{
         /// \brief Constructor taking a configuration object.
         /// @param  sc  The configuration for the simulation
-        SimIDataProvider(__attribute__((unused)) const boost::property_tree::ptree& config) {};
+        SimIDataProvider(__attribute__((unused)) const boost::property_tree::ptree& config)
+            : _version(0), _notifying_thread(std::thread::id()), _next_subscription(1), _notifications_started(false) {};
         /// \brief Destructor.
         virtual ~SimIDataProvider() {};
         //@}
@@ -46,8 +68,133 @@ namespace Nos3
          * @returns                     A data point for the current time.
          */
         virtual boost::shared_ptr<SimIDataPoint> get_data_point() const = 0;
+
+        /// \brief Returns the number of new data points notified so far, to pass to wait_for_next()
+        uint64_t get_version(void) const
+        {
+            std::lock_guard<std::mutex> lock(_version_mutex);
+            return _version;
+        }
         //@}
 
+        /// @name Subscription methods
+        //@{
+        /** \brief Method to be called with each new data point.
+         *
+         *  The callback is called on the thread that received the data, so it should be quick.  It is called
+         *  without any lock held, so it may call subscribe() or unsubscribe().
+         *
+         * @param       callback    The callback to call with each new data point.
+         * @returns                 A subscription identifier for unsubscribe().
+         */
+        uint64_t subscribe(DataPointCallback callback)
+        {
+            uint64_t subscription;
+            {
+                std::lock_guard<std::mutex> lock(_subscriber_mutex);
+                subscription = _next_subscription++;
+                _subscribers[subscription] = boost::shared_ptr<const DataPointCallback>(new DataPointCallback(callback));
+            }
+            start_notifications_once();
+            return subscription;
+        }
+
+        /** \brief Method to stop calling a subscribed callback.  The callback is not running, and will not be called, once this returns,
+         *  unless this is called from a callback, which would otherwise wait for itself.
+         *
+         * @param       subscription    The subscription identifier returned by subscribe().
+         */
+        void unsubscribe(uint64_t subscription)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_subscriber_mutex);
+                _subscribers.erase(subscription);
+            }
+            if (_notifying_thread.load() != std::this_thread::get_id()) {
+                std::lock_guard<std::mutex> lock(_callback_mutex); // acquired once any callback in progress has returned
+            }
+        }
+
+        /** \brief Method to wait for a data point newer than a version.
+         *
+         *  Start with version from get_version() and keep passing the same variable, so no data point
+         *  that arrives between calls is missed.
+         *
+         * @param       version    The version already seen, updated to the current version on return.
+         * @param       timeout    The longest time to wait.
+         * @returns                true if there is a newer data point, false if the wait timed out.
+         */
+        bool wait_for_next(uint64_t& version, std::chrono::milliseconds timeout)
+        {
+            start_notifications_once();
+            std::unique_lock<std::mutex> lock(_version_mutex);
+            bool newer = _version_cv.wait_for(lock, timeout, [this, version]{return _version > version;});
+            version = _version;
+            return newer;
+        }
+        //@}
+
+    protected:
+        /// @name Protected subscription methods
+        //@{
+        /** \brief Method for a derived class to publish that a new data point has arrived.
+         *
+         * @param       dp         The new data point.
+         */
+        void notify_subscribers(const boost::shared_ptr<SimIDataPoint>& dp)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_version_mutex);
+                _version++;
+            }
+            _version_cv.notify_all();
+
+            std::lock_guard<std::mutex> callback_lock(_callback_mutex);
+            _notifying_thread = std::this_thread::get_id();
+            {
+                std::lock_guard<std::mutex> lock(_subscriber_mutex);
+                _callbacks.clear();
+                for (std::map<uint64_t, boost::shared_ptr<const DataPointCallback> >::const_iterator iter = _subscribers.begin(); iter != _subscribers.end(); iter++) {
+                    _callbacks.push_back({iter->first, iter->second});
+                }
+            }
+            // Called without the subscriber lock, so a callback can subscribe or unsubscribe
+            for (size_t i = 0; i < _callbacks.size(); i++) {
+                {
+                    std::lock_guard<std::mutex> lock(_subscriber_mutex);
+                    if (_subscribers.count(_callbacks[i].first) == 0) continue; // removed since the copy, e.g. by an earlier callback
+                }
+                (*_callbacks[i].second)(dp);
+            }
+            _callbacks.clear();
+            _notifying_thread = std::thread::id();
+        }
+
+        /// \brief Called once, when the first subscriber or waiter arrives, by a derived class that has to start watching for new data.
+        virtual void start_notifications(void) {}
+        //@}
+
+    private:
+        void start_notifications_once(void)
+        {
+            std::lock_guard<std::mutex> lock(_version_mutex);
+            if (!_notifications_started) {
+                _notifications_started = true;
+                start_notifications();
+            }
+        }
+
+        // Private data
+        mutable std::mutex _version_mutex;  // protects _version and _notifications_started
+        std::condition_variable _version_cv;
+        uint64_t _version;
+        std::mutex _subscriber_mutex;       // protects _subscribers and _next_subscription
+        std::map<uint64_t, boost::shared_ptr<const DataPointCallback> > _subscribers;  // shared, so they can be called without holding the lock
+        std::mutex _callback_mutex;         // held while calling the callbacks, protects _callbacks
+        std::vector<std::pair<uint64_t, boost::shared_ptr<const DataPointCallback> > > _callbacks;  // the notifying thread's copy of the subscribers
+        std::atomic<std::thread::id> _notifying_thread;  // the thread calling the callbacks, if any
+        uint64_t _next_subscription;
+        bool _notifications_started;
     };
 }
 
@@ -20,48 +20,50 @@
 
 #include <sim_i_data_point.hpp>
 
+#include <blackboard_data.hpp>
+
 namespace Nos3
 {
 
     /** \brief Class to contain an entry of 42 simulation data.
      *
+     *  The data point holds a copy of every field of the shared memory blackboard.
      */
     class SimShmemDataPoint : public SimIDataPoint
     {
     public:
+        /// \brief Constructs a zeroed data point, to be filled through get_data
+        SimShmemDataPoint(void);
         SimShmemDataPoint(double svb[3], double bvb[3], double Hvb[3], double GyroRate[3], int CSSValid[6], double CSSIllum[6], int FSSValid, 
                           double FSSSunAng[2], int STValid, double STqn[4], double GPSPosN[3], double GPSVelN[3], double AccelAcc[3], double WhlH[3]);
-        double* get_svb() {return _svb;}
-        double* get_bvb() {return _bvb;}
-        double* get_Hvb() {return _Hvb;}
-        double* get_GyroRate() {return _GyroRate;}
-        int*    get_CSSValid() {return _CSSValid;}
-        double* get_CSSIllum() {return _CSSIllum;}
-        int      get_FSSValid() {return _FSSValid;}
-        double* get_FSSSunAng() {return _FSSSunAng;}
-        int      get_STValid() {return _STValid;}
-        double* get_STqn() {return _STqn;}
-        double* get_GPSPosN() {return _GPSPosN;}
-        double* get_GPSVelN() {return _GPSVelN;}
-        double* get_AccelAcc() {return _AccelAcc;}
-        double* get_WhlH() {return _WhlH;}
+        /// \brief Constructs a data point from a copy of the blackboard data
+        SimShmemDataPoint(const BlackboardData& data) : _data(data) {}
+        BlackboardData& get_data() {return _data;}
+        const BlackboardData& get_data() const {return _data;}
+        double* get_svb() {return _data.svb;}
+        double* get_bvb() {return _data.bvb;}
+        double* get_Hvb() {return _data.Hvb;}
+        double* get_GyroRate() {return _data.GyroRate;}
+        int*    get_CSSValid() {return _data.CSSValid;}
+        double* get_CSSIllum() {return _data.CSSIllum;}
+        int      get_FSSValid() {return _data.FSSValid;}
+        double* get_FSSSunAng() {return _data.FSSSunAng;}
+        int      get_STValid() {return _data.STValid;}
+        double* get_STqn() {return _data.STqn;}
+        double   get_AbsTime() {return _data.AbsTime;}
+        int      get_GPSWeek() {return _data.GPSWeek;}
+        int      get_GPSSec() {return _data.GPSSec;}
+        double   get_GPSFracSec() {return _data.GPSFracSec;}
+        double* get_GPSPosN() {return _data.GPSPosN;}
+        double* get_GPSVelN() {return _data.GPSVelN;}
+        double* get_GPSPosW() {return _data.GPSPosW;}
+        double* get_GPSVelW() {return _data.GPSVelW;}
+        double* get_AccelAcc() {return _data.AccelAcc;}
+        double* get_WhlH() {return _data.WhlH;}
         std::string to_string(void) const {std::string ret("SimShmemDataPoint"); return ret;}
     protected:
     private:
-        double _svb[3];
-        double _bvb[3];
-        double _Hvb[3];
-        double _GyroRate[3];
-        int    _CSSValid[6];
-        double _CSSIllum[6];
-        int    _FSSValid;
-        double _FSSSunAng[2];
-        int    _STValid;
-        double _STqn[4];
-        double _GPSPosN[3];
-        double _GPSVelN[3];
-        double _AccelAcc[3];
-        double _WhlH[3];
+        BlackboardData _data;
     };
 }
 
@@ -0,0 +1,98 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIMSPSCQUEUE_HPP
+#define NOS3_SIMSPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Nos3
+{
+    /** \brief Bounded, lock free queue for exactly one producer thread and one consumer thread.
+     *
+     *  \details The slots are allocated once.  The producer only writes the tail and the consumer only
+     *  writes the head, each on its own cache line, so a push or pop is a slot move and one store of its
+     *  index.  That store is seq_cst rather than release, so a caller that sets a "waiting" flag and then
+     *  checks the queue, while the other side changes the queue and then checks the flag, cannot have both
+     *  sides miss each other (on x86 this makes the store an xchg).  Neither side ever waits; callers that
+     *  need to sleep when the queue is empty or full do so themselves.
+     */
+    template <typename T>
+    class SimSpscQueue
+    {
+    public:
+        /// @name Constructors
+        //@{
+        /// \brief Constructor taking the most items the queue holds (at least 1)
+        SimSpscQueue(size_t capacity) : _slots((capacity > 0 ? capacity : 1) + 1), _head(0), _tail(0) {}
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Producer only:  moves an item onto the queue... false, leaving item alone, if the queue is full
+        bool try_push(T& item)
+        {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            size_t next = (tail + 1 == _slots.size()) ? 0 : tail + 1;
+            if (next == _head.load(std::memory_order_acquire)) return false;
+            _slots[tail] = std::move(item);
+            _tail.store(next, std::memory_order_seq_cst); // seq_cst, so a consumer about to sleep sees it or is seen waiting
+            return true;
+        }
+
+        /// \brief Consumer only:  moves the oldest item off the queue into item... false if the queue is empty
+        bool try_pop(T& item)
+        {
+            size_t head = _head.load(std::memory_order_relaxed);
+            if (head == _tail.load(std::memory_order_acquire)) return false;
+            item = std::move(_slots[head]);
+            _slots[head] = T(); // do not keep a reference to what was popped
+            _head.store((head + 1 == _slots.size()) ? 0 : head + 1, std::memory_order_seq_cst);
+            return true;
+        }
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the number of items queued, exact from either thread for the other's side
+        size_t size(void) const
+        {
+            size_t head = _head.load(), tail = _tail.load(); // seq_cst, to pair with a waiting flag (see try_push)
+            return (tail >= head) ? tail - head : tail + _slots.size() - head;
+        }
+        /// \brief Returns true if nothing is queued
+        bool empty(void) const {return size() == 0;}
+        /// \brief Returns the most items the queue holds
+        size_t capacity(void) const {return _slots.size() - 1;}
+        //@}
+
+    private:
+        // Disable copying and assignment
+        SimSpscQueue(const SimSpscQueue& other);
+        SimSpscQueue& operator=(const SimSpscQueue& other);
+
+        // Private data
+        std::vector<T> _slots;  // one more than the capacity, so full and empty differ
+        alignas(64) std::atomic<size_t> _head;  // next slot to pop, written by the consumer
+        alignas(64) std::atomic<size_t> _tail;  // next slot to push, written by the producer
+    };
+}
+
+#endif
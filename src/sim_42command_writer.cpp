@@ -0,0 +1,228 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42command_writer.hpp>
+
+namespace Nos3
+{
+
+    extern ItcLogger::Logger *sim_logger;
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Sim42CommandWriter::Sim42CommandWriter(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds,
+        size_t max_queue_depth, int queue_timeout_ms, int batch_window_us)
+        : _endpoint(host + ":" + std::to_string(port)), _max_queue_depth(max_queue_depth > 0 ? max_queue_depth : 1),
+          _queue_timeout(queue_timeout_ms), _batch_window(batch_window_us > 0 ? batch_window_us : 0), _connector(host, port, max_connection_attempts, retry_wait_seconds),
+          _terminating(false), _socket_fd(-1), _stats(), _total_latency_ms(0.0),
+          _writer_thread(&Sim42CommandWriter::writer, this)
+    {
+    }
+
+    Sim42CommandWriter::~Sim42CommandWriter(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _terminating = true;
+            if (_socket_fd >= 0) shutdown(_socket_fd, SHUT_RDWR); // interrupt a write blocked on a full socket
+        }
+        _connector.stop(); // interrupt any connect or backoff wait in progress
+        _queue_cv.notify_all();
+        _space_cv.notify_all();
+        _writer_thread.join();
+        if (!_queue.empty()) {
+            sim_logger->warning("Sim42CommandWriter::~Sim42CommandWriter:  Dropping %lu commands not written to %s", _queue.size(), _endpoint.c_str());
+        }
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    bool Sim42CommandWriter::send(const std::string& command)
+    {
+        if (command.empty()) return true; // nothing to write
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_space_cv.wait_for(lock, _queue_timeout, [this]{return _terminating || (_queue.size() < _max_queue_depth);}) || _terminating)
+        {
+            _stats.commands_dropped++;
+            sim_logger->error("Sim42CommandWriter::send:  %s to %s, dropping command %s", _terminating ? "Not connecting" : "Command queue full",
+                _endpoint.c_str(), command.c_str());
+            return false;
+        }
+        Command queued;
+        queued.text = command;
+        queued.queued = std::chrono::steady_clock::now();
+        _queue.push_back(queued);
+        _stats.queue_depth = _queue.size();
+        _stats.max_queue_depth = std::max(_stats.max_queue_depth, _stats.queue_depth);
+        _queue_cv.notify_one();
+        return true;
+    }
+
+    /*************************************************************************
+     * Accessors
+     *************************************************************************/
+
+    bool Sim42CommandWriter::is_connected(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _socket_fd >= 0;
+    }
+
+    Sim42CommandWriterStats Sim42CommandWriter::get_stats(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Sim42CommandWriterStats stats(_stats);
+        stats.mean_latency_ms = (_stats.commands_sent > 0) ? _total_latency_ms/_stats.commands_sent : 0.0;
+        return stats;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    void Sim42CommandWriter::writer(void)
+    {
+        std::vector<Command> batch;
+        while (true)
+        {
+            int socket_fd;
+            if (!_connector.connect(socket_fd)) {
+                // Keep trying... 42 may simply not be up yet.  Commands queue (and drop once the queue is full) meanwhile.
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_terminating) break;
+                sim_logger->error("Sim42CommandWriter::writer:  Unable to connect COMMAND socket to %s, still trying", _endpoint.c_str());
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _socket_fd = socket_fd;
+                if (_terminating) break;
+            }
+            sim_logger->info("Sim42CommandWriter::writer:  Successfully connected COMMAND socket to %s", _endpoint.c_str());
+
+            while (true)
+            {
+                // Take everything queued since the last write
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _queue_cv.wait(lock, [this]{return _terminating || !_queue.empty();});
+                    if (_terminating) break;
+                    if (_batch_window.count() > 0) {
+                        // Let the rest of this tick's commands arrive before writing
+                        _queue_cv.wait_for(lock, _batch_window, [this]{return _terminating || (_queue.size() >= _max_queue_depth);});
+                        if (_terminating) break;
+                    }
+                    batch.assign(std::make_move_iterator(_queue.begin()), std::make_move_iterator(_queue.end()));
+                    _queue.clear();
+                    _stats.queue_depth = 0;
+                }
+                _space_cv.notify_all();
+
+                size_t sent = write_commands(socket_fd, batch);
+                if (sent < batch.size()) {
+                    // Put back what was not written, to go out first once reconnected
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _queue.insert(_queue.begin(), std::make_move_iterator(batch.begin() + sent), std::make_move_iterator(batch.end()));
+                    _stats.queue_depth = _queue.size();
+                    break;
+                }
+            }
+
+            close_socket();
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_terminating) break;
+            sim_logger->warning("Sim42CommandWriter::writer:  COMMAND connection to %s lost.  Reconnecting.", _endpoint.c_str());
+        }
+        close_socket();
+    }
+
+    size_t Sim42CommandWriter::write_commands(int socket_fd, std::vector<Command>& commands)
+    {
+        size_t index = 0;   // first command not completely written
+        size_t offset = 0;  // bytes of that command already written
+        while (index < commands.size())
+        {
+            struct iovec iov[IOV_MAX];
+            size_t count = 0;
+            for (size_t i = index; (i < commands.size()) && (count < IOV_MAX); i++, count++) {
+                size_t skip = (i == index) ? offset : 0;
+                iov[count].iov_base = const_cast<char *>(commands[i].text.data()) + skip;
+                iov[count].iov_len = commands[i].text.size() - skip;
+            }
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+
+            ssize_t written = sendmsg(socket_fd, &msg, MSG_NOSIGNAL); // writev, without SIGPIPE if 42 went away
+            if ((written < 0) && (errno == EINTR)) continue;
+            if (written <= 0) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_terminating) sim_logger->error("Sim42CommandWriter::write_commands:  Error writing COMMAND socket to %s: %s", _endpoint.c_str(), strerror(errno));
+                if (offset > 0) {
+                    // The rest of a partly written command would be garbage on a new connection
+                    sim_logger->error("Sim42CommandWriter::write_commands:  Dropping partly written command %s", commands[index].text.c_str());
+                    _stats.commands_dropped++;
+                    index++;
+                }
+                return index;
+            }
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stats.writes++;
+            size_t remaining = written;
+            while ((index < commands.size()) && (remaining >= commands[index].text.size() - offset)) {
+                remaining -= commands[index].text.size() - offset;
+                double latency_ms = std::chrono::duration<double, std::milli>(now - commands[index].queued).count();
+                _total_latency_ms += latency_ms;
+                _stats.max_latency_ms = std::max(_stats.max_latency_ms, latency_ms);
+                _stats.commands_sent++;
+                sim_logger->debug("Sim42CommandWriter::write_commands:  Sent command to %s.  Command %s", _endpoint.c_str(), commands[index].text.c_str());
+                index++;
+                offset = 0;
+            }
+            offset += remaining; // a partial write stopped part way through this command... continue from there
+        }
+        return index;
+    }
+
+    void Sim42CommandWriter::close_socket(void)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_socket_fd >= 0) {
+            close(_socket_fd);
+            _socket_fd = -1;
+        }
+    }
+
+}
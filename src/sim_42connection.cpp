@@ -0,0 +1,338 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42binary_frame.hpp>
+#include <sim_42connection.hpp>
+
+namespace Nos3
+{
+
+    extern ItcLogger::Logger *sim_logger;
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Sim42Connection::Sim42Connection(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds,
+        const Sim42PipelineOptions& pipeline)
+        : _connector(host, port, max_connection_attempts, retry_wait_seconds), _socket_fd(-1), _connected(false),
+          _reader_thread(NULL), _not_terminating(true), _pipeline(pipeline), _queue(pipeline.queue_depth), _parser_thread(NULL),
+          _reader_waiting(false), _parser_waiting(false), _max_queue_depth(0), _frames_read(0), _frames_parsed(0), _frames_dropped(0),
+          _eager_subscribers(0)
+    {
+    }
+
+    Sim42Connection::~Sim42Connection(void)
+    {
+        _not_terminating = false;
+        _connector.stop(); // interrupt any connect or backoff wait in progress
+        {
+            std::lock_guard<std::mutex> lock(_socket_mutex);
+            if (_socket_fd >= 0) shutdown(_socket_fd, SHUT_RDWR); // wake the reader thread if it is blocked in recv
+        }
+        {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _wait_cv.notify_all(); // wake the reader or parser thread if it is waiting on the queue
+        }
+        if (_reader_thread != NULL) {
+            _reader_thread->join();
+            delete _reader_thread;
+        }
+        if (_parser_thread != NULL) {
+            _parser_thread->join();
+            delete _parser_thread;
+        }
+        sim_logger->debug("Sim42Connection::~Sim42Connection:  Closed TELEMETRY connection %s", get_endpoint().c_str());
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    void Sim42Connection::start(void)
+    {
+        _parser_thread = new std::thread(std::bind(&Sim42Connection::telemetry_parser, this));
+        _reader_thread = new std::thread(std::bind(&Sim42Connection::telemetry_socket_reader, this)); // Spawn thread to connect to and read from socket
+        sim_logger->debug("Sim42Connection::start:  Started TELEMETRY connection thread for %s", get_endpoint().c_str());
+    }
+
+    void Sim42Connection::add_subscriber(uint64_t id, FrameCallback callback, bool lazy_parsing,
+        const boost::shared_ptr<const Sim42KeyFilter>& filter)
+    {
+        std::lock_guard<std::mutex> lock(_subscriber_mutex);
+        remove_subscriber_locked(id);
+        Subscriber subscriber = {boost::shared_ptr<const FrameCallback>(new FrameCallback(callback)), lazy_parsing, filter};
+        _subscribers[id] = subscriber;
+        if (!lazy_parsing) _eager_subscribers++;
+        update_filter_locked();
+    }
+
+    size_t Sim42Connection::remove_subscriber(uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(_subscriber_mutex);
+        remove_subscriber_locked(id);
+        update_filter_locked();
+        return _subscribers.size();
+    }
+
+    void Sim42Connection::wait_for_callbacks(void)
+    {
+        if (is_callback_thread()) return;
+        std::lock_guard<std::mutex> lock(_callback_mutex); // acquired once the parser thread has finished calling back
+    }
+
+    bool Sim42Connection::record_to(const std::string& filename)
+    {
+        std::lock_guard<std::mutex> lock(_recorder_mutex);
+        boost::shared_ptr<Sim42FrameRecorder> recorder(boost::atomic_load(&_recorder));
+        if (recorder) {
+            if (recorder->get_filename() == filename) return true; // another subscriber asked for the same log
+            sim_logger->error("Sim42Connection::record_to:  TELEMETRY %s is already recording to %s, not recording to %s",
+                get_endpoint().c_str(), recorder->get_filename().c_str(), filename.c_str());
+            return false;
+        }
+        recorder.reset(new Sim42FrameRecorder(filename));
+        if (!recorder->is_open()) return false;
+        boost::atomic_store(&_recorder, recorder);
+        return true;
+    }
+
+    /*************************************************************************
+     * Accessors
+     *************************************************************************/
+
+    Sim42PipelineStats Sim42Connection::get_pipeline_stats(void) const
+    {
+        Sim42PipelineStats stats;
+        stats.queue_depth = _queue.size();
+        stats.max_queue_depth = _max_queue_depth;
+        stats.frames_read = _frames_read;
+        stats.frames_parsed = _frames_parsed;
+        stats.frames_dropped = _frames_dropped;
+        return stats;
+    }
+
+    bool Sim42Connection::is_callback_thread(void) const
+    {
+        return (_parser_thread != NULL) && (_parser_thread->get_id() == std::this_thread::get_id());
+    }
+
+    Sim42OverloadPolicy Sim42PipelineOptions::parse_overload_policy(const std::string& name)
+    {
+        if (name.compare("block") == 0) return SIM42_OVERLOAD_BLOCK;
+        if (name.compare("drop-newest") == 0) return SIM42_OVERLOAD_DROP_NEWEST;
+        if (name.compare("latest-only") == 0) return SIM42_OVERLOAD_LATEST_ONLY;
+        sim_logger->warning("Sim42PipelineOptions::parse_overload_policy:  Unknown overload policy %s, using block", name.c_str());
+        return SIM42_OVERLOAD_BLOCK;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    void Sim42Connection::remove_subscriber_locked(uint64_t id)
+    {
+        std::map<uint64_t, Subscriber>::iterator iter = _subscribers.find(id);
+        if (iter == _subscribers.end()) return;
+        if (!iter->second.lazy_parsing) _eager_subscribers--;
+        _subscribers.erase(iter);
+    }
+
+    void Sim42Connection::update_filter_locked(void)
+    {
+        boost::shared_ptr<Sim42KeyFilter> filter(new Sim42KeyFilter());
+        for (std::map<uint64_t, Subscriber>::const_iterator iter = _subscribers.begin(); iter != _subscribers.end(); iter++) {
+            if (!iter->second.filter || iter->second.filter->empty()) {
+                filter.reset(); // this subscriber reads every key
+                break;
+            }
+            filter->add_patterns(*iter->second.filter);
+        }
+        boost::atomic_store(&_filter, boost::shared_ptr<const Sim42KeyFilter>(filter));
+    }
+
+    void Sim42Connection::telemetry_socket_reader(void)
+    {
+
+        while (_not_terminating)
+        {
+            int socket_fd;
+            if (!_connector.connect(socket_fd))
+            {
+                if (_not_terminating) sim_logger->error("Sim42Connection::telemetry_socket_reader:  Giving up on TELEMETRY connection %s :-(", get_endpoint().c_str());
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(_socket_mutex);
+                _socket_fd = socket_fd;
+            }
+            if (!_not_terminating) shutdown(socket_fd, SHUT_RDWR); // the destructor may have missed this socket
+            _frame_reader.reset(socket_fd);
+            _field_table.reset(); // the sender starts each connection with its field table
+            _connected = true;
+            sim_logger->info("Sim42Connection::telemetry_socket_reader:  Connected TELEMETRY %s", get_endpoint().c_str());
+
+            boost::shared_ptr<Sim42FrameArena> arena;
+            while (_not_terminating)
+            {
+                // Read into a recycled arena and hand it to the parser thread... a dropped frame's arena is read into again
+                if (!arena) arena = Sim42FrameArenaPool::Instance().acquire();
+                if (_pipeline.binary_frames) {
+                    if (!read_binary_frame(*arena)) break;
+                } else {
+                    boost::shared_ptr<const Sim42KeyFilter> filter;
+                    if (!boost::atomic_load(&_recorder)) filter = boost::atomic_load(&_filter); // a recording has every line
+                    if (!_frame_reader.read_frame(arena->text, filter.get())) break;
+                }
+                _frames_read++;
+                if (!queue_frame(arena)) _frames_dropped++;
+            }
+
+            _connected = false;
+            {
+                std::lock_guard<std::mutex> lock(_socket_mutex);
+                close(_socket_fd);
+                _socket_fd = -1;
+            }
+            if (_not_terminating) sim_logger->warning("Sim42Connection::telemetry_socket_reader:  TELEMETRY connection %s lost after %lu frames, %lu bytes.  Reconnecting.",
+                get_endpoint().c_str(), _frame_reader.get_total_frames(), _frame_reader.get_total_bytes());
+        }
+    }
+
+    bool Sim42Connection::read_binary_frame(Sim42FrameArena& arena)
+    {
+        uint32_t type;
+        while (_frame_reader.read_message(arena.text, type))
+        {
+            if (type == SIM42BIN_FIELD_TABLE) {
+                boost::shared_ptr<Sim42Schema> table(new Sim42Schema());
+                if (!table->add_binary_field_table(arena.text.data(), arena.text.size())) {
+                    sim_logger->error("Sim42Connection::read_binary_frame:  Malformed field table from TELEMETRY %s", get_endpoint().c_str());
+                    return false;
+                }
+                _field_table = table;
+                sim_logger->info("Sim42Connection::read_binary_frame:  TELEMETRY %s field table has %lu fields, %u values",
+                    get_endpoint().c_str(), table->get_keys().size(), table->get_value_count());
+            } else if (type == SIM42BIN_DATA) {
+                if (_field_table) {
+                    arena.field_table = _field_table;
+                    return true;
+                }
+                sim_logger->warning("Sim42Connection::read_binary_frame:  Ignoring data before a field table from TELEMETRY %s", get_endpoint().c_str());
+            } else {
+                sim_logger->debug("Sim42Connection::read_binary_frame:  Ignoring message type %u from TELEMETRY %s", type, get_endpoint().c_str());
+            }
+        }
+        return false;
+    }
+
+    bool Sim42Connection::queue_frame(boost::shared_ptr<Sim42FrameArena>& arena)
+    {
+        if (!_queue.try_push(arena)) {
+            if (_pipeline.overload_policy != SIM42_OVERLOAD_BLOCK) return false;
+
+            std::unique_lock<std::mutex> lock(_wait_mutex);
+            _reader_waiting = true;
+            bool queued = false;
+            while (_not_terminating && !(queued = _queue.try_push(arena))) {
+                _wait_cv.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            _reader_waiting = false;
+            if (!queued) return true; // terminating... not a drop
+        }
+
+        uint64_t depth = _queue.size();
+        if (depth > _max_queue_depth) _max_queue_depth = depth; // only this thread writes it
+        wake(_parser_waiting);
+        return true;
+    }
+
+    void Sim42Connection::telemetry_parser(void)
+    {
+        while (_not_terminating)
+        {
+            boost::shared_ptr<Sim42FrameArena> arena;
+            if (!_queue.try_pop(arena)) {
+                std::unique_lock<std::mutex> lock(_wait_mutex);
+                _parser_waiting = true;
+                while (_not_terminating && _queue.empty()) {
+                    _wait_cv.wait_for(lock, std::chrono::milliseconds(100));
+                }
+                _parser_waiting = false;
+                continue;
+            }
+            if (_pipeline.overload_policy == SIM42_OVERLOAD_LATEST_ONLY) {
+                boost::shared_ptr<Sim42FrameArena> newer;
+                while (_queue.try_pop(newer)) {
+                    arena = newer;
+                    _frames_dropped++;
+                }
+            }
+            wake(_reader_waiting);
+
+            // Parse once, outside the subscriber lock, then share the result with every subscriber
+            boost::shared_ptr<Sim42DataPoint> dp(new Sim42DataPoint(arena, _eager_subscribers == 0));
+            if (!dp->is_valid()) {
+                _frames_dropped++; // rejected when parsed (logged there)... subscribers keep the last good frame
+                continue;
+            }
+            boost::shared_ptr<Sim42FrameRecorder> recorder(boost::atomic_load(&_recorder));
+            if (recorder) recorder->record(*dp);
+            {
+                std::lock_guard<std::mutex> callback_lock(_callback_mutex);
+                {
+                    std::lock_guard<std::mutex> lock(_subscriber_mutex);
+                    _callbacks.clear();
+                    for (std::map<uint64_t, Subscriber>::const_iterator iter = _subscribers.begin(); iter != _subscribers.end(); iter++) {
+                        _callbacks.push_back({iter->first, iter->second.callback});
+                    }
+                }
+                // Called without the subscriber lock, so a callback can subscribe or unsubscribe
+                for (size_t i = 0; i < _callbacks.size(); i++) {
+                    {
+                        std::lock_guard<std::mutex> lock(_subscriber_mutex);
+                        if (_subscribers.count(_callbacks[i].first) == 0) continue; // removed since the copy, e.g. by an earlier callback
+                    }
+                    (*_callbacks[i].second)(dp);
+                }
+                _callbacks.clear();
+            }
+            _frames_parsed++;
+        }
+    }
+
+    void Sim42Connection::wake(const std::atomic<bool>& waiting)
+    {
+        // The waiting flag is set before the queue is checked, and the queue changed before the flag is checked here,
+        // so either the waiter sees the change or the change sees the waiter... the lock closes the gap before the wait
+        if (waiting) {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _wait_cv.notify_all();
+        }
+    }
+
+}
@@ -0,0 +1,118 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <thread>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42connection_manager.hpp>
+
+namespace Nos3
+{
+    extern ItcLogger::Logger *sim_logger;
+
+    Sim42ConnectionManager& Sim42ConnectionManager::Instance()
+    {
+        // Meyers Singleton, thread-safe in C++ 11
+        static Sim42ConnectionManager manager;
+        return manager;
+    }
+
+    uint64_t Sim42ConnectionManager::subscribe(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds,
+        Sim42Connection::FrameCallback callback, bool lazy_parsing, const boost::shared_ptr<const Sim42KeyFilter>& filter,
+        const Sim42PipelineOptions& pipeline, const std::string& record_file)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::string endpoint(host + ":" + std::to_string(port));
+
+        std::map<std::string, boost::shared_ptr<Sim42Connection> >::iterator iter = _connections.find(endpoint);
+        bool created = (iter == _connections.end());
+        if (created)
+        {
+            boost::shared_ptr<Sim42Connection> connection(new Sim42Connection(host, port, max_connection_attempts, retry_wait_seconds, pipeline));
+            iter = _connections.insert({endpoint, connection}).first;
+            sim_logger->info("Sim42ConnectionManager::subscribe:  Created shared TELEMETRY connection %s", endpoint.c_str());
+        }
+        else
+        {
+            const Sim42PipelineOptions& existing = iter->second->get_pipeline_options();
+            if ((existing.queue_depth != pipeline.queue_depth) || (existing.overload_policy != pipeline.overload_policy) ||
+                (existing.binary_frames != pipeline.binary_frames))
+            {
+                sim_logger->warning("Sim42ConnectionManager::subscribe:  Shared TELEMETRY connection %s already has queue depth %lu, overload policy %d, %s frames;"
+                    " ignoring the requested queue depth %lu, overload policy %d, %s frames", endpoint.c_str(),
+                    existing.queue_depth, (int)existing.overload_policy, existing.binary_frames ? "binary" : "text",
+                    pipeline.queue_depth, (int)pipeline.overload_policy, pipeline.binary_frames ? "binary" : "text");
+            }
+        }
+
+        if (!record_file.empty()) iter->second->record_to(record_file); // before starting, so the log has the first frame
+
+        uint64_t subscription = _next_subscription++;
+        iter->second->add_subscriber(subscription, callback, lazy_parsing, filter);
+        _subscriptions.insert({subscription, endpoint});
+        if (created) iter->second->start(); // after the first subscriber is added, so it gets the first frame
+        sim_logger->debug("Sim42ConnectionManager::subscribe:  Subscription %lu added to TELEMETRY connection %s", subscription, endpoint.c_str());
+        return subscription;
+    }
+
+    void Sim42ConnectionManager::unsubscribe(uint64_t subscription)
+    {
+        boost::shared_ptr<Sim42Connection> connection; // waited for, or destroyed (joined), after the lock is released
+        bool closing = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::map<uint64_t, std::string>::iterator sub = _subscriptions.find(subscription);
+            if (sub == _subscriptions.end()) return;
+
+            std::map<std::string, boost::shared_ptr<Sim42Connection> >::iterator conn = _connections.find(sub->second);
+            if (conn != _connections.end())
+            {
+                connection = conn->second;
+                if (connection->remove_subscriber(subscription) == 0)
+                {
+                    sim_logger->info("Sim42ConnectionManager::unsubscribe:  Last subscriber left, closing shared TELEMETRY connection %s", sub->second.c_str());
+                    closing = true;
+                    _connections.erase(conn);
+                }
+            }
+            _subscriptions.erase(sub);
+        }
+
+        if (!connection) return;
+        if (!closing)
+        {
+            connection->wait_for_callbacks(); // so the caller can destroy what its callback uses
+        }
+        else if (connection->is_callback_thread())
+        {
+            // The last subscriber left from its own callback... the connection cannot join the thread it is called on, so close it from another
+            std::thread([connection]() mutable {connection.reset();}).detach();
+        }
+    }
+
+    Sim42PipelineStats Sim42ConnectionManager::get_pipeline_stats(uint64_t subscription)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::map<uint64_t, std::string>::const_iterator sub = _subscriptions.find(subscription);
+        if (sub != _subscriptions.end()) {
+            std::map<std::string, boost::shared_ptr<Sim42Connection> >::const_iterator conn = _connections.find(sub->second);
+            if (conn != _connections.end()) return conn->second->get_pipeline_stats();
+        }
+        return Sim42PipelineStats();
+    }
+}
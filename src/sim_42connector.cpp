@@ -0,0 +1,219 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42connector.hpp>
+
+namespace Nos3
+{
+
+    extern ItcLogger::Logger *sim_logger;
+
+    std::mutex Sim42Connector::_cache_mutex;
+    std::map<std::string, std::vector<Sim42Connector::Address> > Sim42Connector::_cache;
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Sim42Connector::Sim42Connector(const std::string& host, uint16_t port, int max_connection_attempts, int retry_wait_seconds)
+        : _host(host), _port(port), _max_connection_attempts(max_connection_attempts), _retry_wait_seconds(retry_wait_seconds), _connected_once(false), _stopping(false)
+    {
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    bool Sim42Connector::connect(int &socket_fd)
+    {
+        std::vector<Address> addresses;
+        bool refresh = false;
+        int failures = 0;
+        int max_wait_ms = std::max(_retry_wait_seconds * 1000, (int)MIN_RETRY_WAIT_MS);
+        int wait_ms = MIN_RETRY_WAIT_MS;
+        long waited_ms = 0;
+        const long give_up_ms = (long)_max_connection_attempts * max_wait_ms; // as long as the attempts would take at the full wait
+
+        while (!is_stopped())
+        {
+            if (resolve(addresses, refresh) && connect_once(addresses, socket_fd))
+            {
+                sim_logger->debug("Sim42Connector::connect:  Connected host %s, port %u after %d failed attempts", _host.c_str(), _port, failures);
+                _connected_once = true;
+                return true;
+            }
+            if (is_stopped()) break;
+
+            refresh = true; // the cached addresses did not work, resolve again next time
+            failures++;
+            if (!_connected_once && (_max_connection_attempts >= 0) && (failures > _max_connection_attempts) && (waited_ms >= give_up_ms))
+            {
+                sim_logger->error("Sim42Connector::connect:  Maximum number of connection attempts reached.   Host %s, port %u failed to connect!", _host.c_str(), _port);
+                return false;
+            }
+            sim_logger->warning("Sim42Connector::connect:  Warning... failed to connect host %s, port %u... retrying in %d ms.", _host.c_str(), _port, wait_ms);
+            if (!wait(std::chrono::milliseconds(wait_ms))) break;
+            waited_ms += wait_ms;
+            wait_ms = std::min(wait_ms * 2, max_wait_ms);
+        }
+        return false;
+    }
+
+    void Sim42Connector::stop(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _stop_cv.notify_all();
+    }
+
+    /*************************************************************************
+     * Accessors
+     *************************************************************************/
+
+    bool Sim42Connector::is_stopped(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stopping;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    bool Sim42Connector::resolve(std::vector<Address>& addresses, bool refresh)
+    {
+        std::string endpoint(get_endpoint());
+        if (!refresh)
+        {
+            std::lock_guard<std::mutex> lock(_cache_mutex);
+            std::map<std::string, std::vector<Address> >::const_iterator cached = _cache.find(endpoint);
+            if (cached != _cache.end())
+            {
+                addresses = cached->second;
+                return true;
+            }
+        }
+
+        // Resolve without the cache lock, so a slow name does not hold up connectors to other endpoints
+
+        // http://beej.us/guide/bgnet/output/html/singlepage/bgnet.html
+        struct addrinfo hints, *servinfo, *p;
+        int rv;
+
+        memset(&hints, 0, sizeof hints);
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        if ((rv = getaddrinfo(_host.c_str(), std::to_string(_port).c_str(), &hints, &servinfo)) != 0)
+        {
+            sim_logger->warning("Sim42Connector::resolve:  Error getting address for host %s, port %u: %s", _host.c_str(), _port, gai_strerror(rv));
+            return false;
+        }
+
+        addresses.clear();
+        for (p = servinfo; p != NULL; p = p->ai_next)
+        {
+            Address address;
+            address.family = p->ai_family;
+            address.socktype = p->ai_socktype;
+            address.protocol = p->ai_protocol;
+            memcpy(&address.addr, p->ai_addr, p->ai_addrlen);
+            address.addrlen = p->ai_addrlen;
+            addresses.push_back(address);
+        }
+        freeaddrinfo(servinfo);
+
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        _cache[endpoint] = addresses;
+        return !addresses.empty();
+    }
+
+    bool Sim42Connector::connect_once(const std::vector<Address>& addresses, int &socket_fd)
+    {
+        // loop through all the addresses and connect to the first we can
+        for (std::vector<Address>::const_iterator a = addresses.begin(); a != addresses.end(); a++)
+        {
+            if ((socket_fd = socket(a->family, a->socktype, a->protocol)) == -1)
+            {
+                sim_logger->warning("Sim42Connector::connect_once:  Continuing, but could not create socket for host %s, port %u: %s", _host.c_str(), _port, strerror(errno));
+                continue;
+            }
+
+            // Connect without blocking so stop() is noticed while the connect is in progress
+            int flags = fcntl(socket_fd, F_GETFL, 0);
+            fcntl(socket_fd, F_SETFL, flags | O_NONBLOCK);
+            bool connected = (::connect(socket_fd, (const struct sockaddr *)&a->addr, a->addrlen) == 0) ||
+                ((errno == EINPROGRESS) && wait_for_connect(socket_fd));
+            if (connected)
+            {
+                fcntl(socket_fd, F_SETFL, flags);
+                return true;
+            }
+            sim_logger->debug("Sim42Connector::connect_once:  Continuing, but could not connect socket for host %s, port %u: %s", _host.c_str(), _port, strerror(errno));
+            close(socket_fd);
+        }
+        socket_fd = -1;
+        return false;
+    }
+
+    bool Sim42Connector::wait_for_connect(int socket_fd)
+    {
+        struct pollfd pfd;
+        pfd.fd = socket_fd;
+        pfd.events = POLLOUT;
+
+        for (int waited_ms = 0; (waited_ms < CONNECT_TIMEOUT_MS) && !is_stopped(); waited_ms += 100)
+        {
+            int result = poll(&pfd, 1, 100);
+            if (result > 0)
+            {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(socket_fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                errno = error;
+                return error == 0;
+            }
+            else if ((result < 0) && (errno != EINTR))
+            {
+                return false;
+            }
+        }
+        errno = ETIMEDOUT;
+        return false;
+    }
+
+    bool Sim42Connector::wait(std::chrono::milliseconds duration)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return !_stop_cv.wait_for(lock, duration, [this]{return _stopping;});
+    }
+
+}
@@ -15,12 +15,18 @@
    ivv-itc@lists.nasa.gov
 */
 
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <limits>
-
-#include <boost/algorithm/string.hpp>
-#include <boost/tokenizer.hpp>
-#include <boost/lexical_cast.hpp>
+#include <sstream>
+#include <stdexcept>
 
 #include <ItcLogger/Logger.hpp>
 
@@ -31,76 +37,377 @@ namespace Nos3
 
     extern ItcLogger::Logger *sim_logger;
 
+    namespace
+    {
+        // Offsets of the derived values in Sim42FrameArena::derived
+        const size_t MONTH_OFFSET = 0;
+        const size_t DAY_OFFSET = 16;
+        const size_t ABSTIME_OFFSET = 32;
+        const size_t TIME_OFFSET = 64;  // TIME value of a binary frame
+
+        std::string_view trim(std::string_view text)
+        {
+            size_t begin = 0, end = text.size();
+            while ((begin < end) && isspace((unsigned char)text[begin])) begin++;
+            while ((end > begin) && isspace((unsigned char)text[end - 1])) end--;
+            return text.substr(begin, end - begin);
+        }
+
+        bool key_less(const Sim42FrameArena::KeyValue& kv, std::string_view key)
+        {
+            return kv.first < key;
+        }
+
+        // Matches a line against a key, as parse_lines would split it... the key (a view of the line) and value if it does
+        bool line_has_key(std::string_view line, std::string_view key, std::string_view& line_key, std::string_view& value)
+        {
+            size_t begin = 0;
+            while ((begin < line.size()) && isspace((unsigned char)line[begin])) begin++;
+            if (line.compare(begin, key.size(), key) != 0) return false;
+            line_key = line.substr(begin, key.size());
+            std::string_view rest(line.substr(begin + key.size()));
+            size_t equals = rest.find('=');
+            if (trim(rest.substr(0, equals)).size() > 0) return false; // a longer key, or a key without a value with more words
+            value = (equals == std::string_view::npos) ? std::string_view() : trim(rest.substr(equals + 1));
+            return (equals != std::string_view::npos) || (line.find('=') == std::string_view::npos);
+        }
+
+        inline bool is_separator(char c)
+        {
+            return (c == '[') || (c == ']') || (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+        }
+
+        // Parses the next number of text at p, skipping separators... false at the end or at text that is not a number
+        inline bool parse_next(const char *&p, const char *end, double& value)
+        {
+            while ((p < end) && is_separator(*p)) p++;
+            if ((p < end) && (*p == '+')) p++; // from_chars does not take a leading plus
+            std::from_chars_result result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+
+        // Appends white space separated numbers, optionally in brackets... false if any token is not a number or there are none
+        bool parse_numbers(std::string_view text, std::vector<double>& numbers)
+        {
+            const char *p = text.data(), *end = text.data() + text.size();
+            size_t first = numbers.size();
+            double value;
+            while (parse_next(p, end, value)) numbers.push_back(value);
+            while ((p < end) && is_separator(*p)) p++;
+            if ((p == end) && (numbers.size() > first)) return true;
+            numbers.resize(first);
+            return false;
+        }
+
+        std::string format_numbers(const std::vector<double>& numbers, bool bracketed)
+        {
+            std::stringstream ss;
+            ss << std::setprecision(std::numeric_limits<double>::max_digits10);
+            if (bracketed) ss << "[";
+            for (std::vector<double>::const_iterator it = numbers.begin(); it != numbers.end(); ++it) {
+                if (it != numbers.begin()) ss << " ";
+                ss << *it;
+            }
+            if (bracketed) ss << "]";
+            return ss.str();
+        }
+
+        // 42 writes discrete values (modes, flags, counts) as integers, which are not interpolated
+        bool is_integer_text(std::string_view text)
+        {
+            return text.find_first_of(".eE") == std::string_view::npos;
+        }
+
+        bool is_discrete_key(const Sim42KeyFilter *discrete, std::string_view key)
+        {
+            return (discrete != NULL) && !discrete->empty() && discrete->matches(key.data(), key.size()); // an empty filter matches every key
+        }
+
+        bool is_quaternion_key(std::string_view key)
+        {
+            size_t dot = key.rfind('.');
+            return key.compare((dot == std::string_view::npos) ? 0 : dot + 1, 1, "q") == 0;
+        }
+
+        // Spherical linear interpolation from q0 to q1, result in q0
+        void slerp(std::vector<double>& q0, const std::vector<double>& q1, double fraction)
+        {
+            double dot = q0[0]*q1[0] + q0[1]*q1[1] + q0[2]*q1[2] + q0[3]*q1[3];
+            double sign = 1.0;
+            if (dot < 0.0) { // q and -q are the same rotation... take the short way around
+                dot = -dot;
+                sign = -1.0;
+            }
+            double s0, s1;
+            if (dot > 0.9995) { // nearly parallel, linear interpolation is accurate and avoids dividing by sin(~0)
+                s0 = 1.0 - fraction;
+                s1 = fraction;
+            } else {
+                double theta = acos(dot);
+                s0 = sin((1.0 - fraction)*theta)/sin(theta);
+                s1 = sin(fraction*theta)/sin(theta);
+            }
+            double norm = 0.0;
+            for (int i = 0; i < 4; i++) {
+                q0[i] = s0*q0[i] + sign*s1*q1[i];
+                norm += q0[i]*q0[i];
+            }
+            norm = sqrt(norm);
+            if (norm > 0.0) for (int i = 0; i < 4; i++) q0[i] /= norm;
+        }
+    }
+
     /*************************************************************************
      * Constructors
      *************************************************************************/
 
-    Sim42DataPoint::Sim42DataPoint(std::vector<std::string> &message) : _lines(message)
+    Sim42DataPoint::Sim42DataPoint(std::vector<std::string> &message) : _arena(Sim42FrameArenaPool::Instance().acquire())
     {
-        for (std::vector<std::string>::const_iterator iter = _lines.begin(); iter != _lines.end(); iter++) {
-            size_t equals = iter->find("=");
-            if (equals != std::string::npos) {
-                std::string key(iter->substr(0, equals));
-                boost::trim(key);
-                std::string value(iter->substr(equals+1));
-                boost::trim(value);
-                _key_values.insert({key, value});
-            } else if(iter->compare(0, 4, "TIME") == 0) {
-                std::string value(iter->substr(4));
-                boost::trim(value);
-                _key_values.insert({"TIME", value});
-                parse_time(value);
-                long Month, Day;
-                DOY2MD(std::stol(_key_values["YEAR"]), std::stol(_key_values["DOY"]), &Month, &Day);
-                _key_values.insert({"MONTH", std::to_string(Month)});
-                _key_values.insert({"DAY", std::to_string(Day)});
-                _key_values.insert({"ABSTIME", 
-                    std::to_string(DateToTime(std::stol(_key_values["YEAR"]), Month, Day, 
-                    std::stol(_key_values["HOUR"]), std::stol(_key_values["MINUTE"]), std::stod(_key_values["SECOND"])))});
-            } else {
-                std::string key(*iter);
-                boost::trim(key);
-                _key_values.insert({key, ""});
-            }
+        for (std::vector<std::string>::const_iterator iter = message.begin(); iter != message.end(); iter++) {
+            _arena->text.append(*iter);
+            _arena->text.push_back('\n');
         }
-        sim_logger->trace("Sim42DataPoint::Sim42DataPoint:  Constructed data point with:  %s", to_string().c_str());
-        sim_logger->trace("Sim42DataPoint::Sim42DataPoint - key/values:");
-        for (std::map<std::string, std::string>::const_iterator iter = _key_values.begin(); iter != _key_values.end(); iter++) {
-            sim_logger->trace("  %s, %s", iter->first.c_str(), iter->second.c_str());
+        _arena->frame = _arena->text;
+        parse_lines(false);
+    }
+
+    Sim42DataPoint::Sim42DataPoint(const char *text, size_t length, bool lazy) : _arena(Sim42FrameArenaPool::Instance().acquire())
+    {
+        _arena->text.assign(text, length);
+        _arena->frame = _arena->text;
+        parse_lines(lazy);
+    }
+
+    Sim42DataPoint::Sim42DataPoint(const char *text, size_t length, const boost::shared_ptr<const void>& owner, bool lazy)
+        : _arena(Sim42FrameArenaPool::Instance().acquire())
+    {
+        _arena->owner = owner;
+        _arena->frame = std::string_view(text, length);
+        parse_lines(lazy);
+    }
+
+    Sim42DataPoint::Sim42DataPoint(const boost::shared_ptr<Sim42FrameArena>& arena, bool lazy) : _arena(arena)
+    {
+        if (_arena->field_table) {
+            parse_binary();
+            return;
         }
+        if (_arena->owner == NULL) _arena->frame = _arena->text;
+        parse_lines(lazy);
     }
 
     /*************************************************************************
-     * Accessors
+     * Mutators
      *************************************************************************/
 
     void Sim42DataPoint::parse_time(const std::string& value)
     {
-        std::vector<std::string> tokens;
-        std::istringstream iss(value);
-        std::string token;
-        while (std::getline(iss, token, '-')) {
-            tokens.push_back(token);
+        if (has_time()) return; // the time keys are already there, and are kept
+        {
+            // Copy on write:  the arena may be shared with other data points and read by other threads (e.g. the provider's
+            // latest snapshot, whose Sim42DataPoint may itself be shared), so the frame goes into a new arena rather than
+            // changing one any reader may hold
+            std::string_view frame(get_text());
+            Sim42DataPoint copy(frame.empty() ? "" : frame.data(), frame.size(), is_lazy());
+            _arena = copy._arena;
+        }
+        // Keep the text in the arena, since the keys are views of it
+        size_t length = std::min(value.size(), sizeof(_arena->derived) - TIME_OFFSET - 1);
+        memcpy(_arena->derived + TIME_OFFSET, value.data(), length);
+        _arena->derived[TIME_OFFSET + length] = '\0';
+        parse_time_value(std::string_view(_arena->derived + TIME_OFFSET, length));
+        std::stable_sort(_arena->key_values.begin(), _arena->key_values.end(),
+            [](const Sim42FrameArena::KeyValue& a, const Sim42FrameArena::KeyValue& b){return a.first < b.first;});
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    void Sim42DataPoint::parse_lines(bool lazy)
+    {
+        _arena->lazy = lazy;
+        std::string_view frame(_arena->frame);
+        while (!frame.empty()) {
+            size_t newline = frame.find('\n');
+            _arena->lines.push_back(frame.substr(0, newline));
+            frame.remove_prefix((newline == std::string_view::npos) ? frame.size() : newline + 1);
+        }
+
+        for (std::vector<std::string_view>::const_iterator iter = _arena->lines.begin(); iter != _arena->lines.end(); iter++) {
+            size_t equals = iter->find('=');
+            if (lazy && ((equals != std::string_view::npos) || (iter->compare(0, 4, "TIME") != 0))) continue; // located on first access instead
+            if (equals != std::string_view::npos) {
+                _arena->key_values.push_back({trim(iter->substr(0, equals)), trim(iter->substr(equals+1))});
+            } else if(iter->compare(0, 4, "TIME") == 0) {
+                std::string_view value(trim(iter->substr(4)));
+                _arena->key_values.push_back({"TIME", value});
+                parse_time_value(value);
+            } else {
+                _arena->key_values.push_back({trim(*iter), std::string_view()});
+            }
+        }
+        // Sorted for binary search... stable, so the first of any duplicate keys is found, as before
+        std::stable_sort(_arena->key_values.begin(), _arena->key_values.end(),
+            [](const Sim42FrameArena::KeyValue& a, const Sim42FrameArena::KeyValue& b){return a.first < b.first;});
+
+        if (sim_logger->is_level_enabled(ItcLogger::LOGGER_TRACE)) { // building the dump costs more than parsing the frame
+            sim_logger->trace("Sim42DataPoint::Sim42DataPoint:  Constructed %sdata point with:  %s", lazy ? "lazy " : "", to_string().c_str());
+            sim_logger->trace("Sim42DataPoint::Sim42DataPoint - key/values:");
+            for (std::vector<Sim42FrameArena::KeyValue>::const_iterator iter = _arena->key_values.begin(); iter != _arena->key_values.end(); iter++) {
+                sim_logger->trace("  %.*s, %.*s", (int)iter->first.size(), iter->first.data(), (int)iter->second.size(), iter->second.data());
+            }
+        }
+    }
+
+    void Sim42DataPoint::parse_binary(void)
+    {
+        _arena->lazy = true; // fields are formatted as text only when asked for
+        uint64_t expected = sizeof(Sim42BinaryTime) + (uint64_t)_arena->field_table->get_value_count()*sizeof(double);
+        if (_arena->text.size() != expected) {
+            sim_logger->error("Sim42DataPoint::parse_binary:  Binary frame has %lu bytes, its field table needs %lu, ignoring the frame",
+                _arena->text.size(), (unsigned long)expected);
+            _arena->field_table.reset();
+            _arena->text.clear();
+            _arena->malformed = true; // the connection drops it rather than publish an empty frame
+            return;
+        }
+
+        // The TIME value as the ASCII frame has it, so the time keys and fields are exactly those of a text frame
+        Sim42BinaryTime time;
+        memcpy(&time, _arena->text.data(), sizeof(time));
+        char *text = _arena->derived + TIME_OFFSET;
+        int length = snprintf(text, sizeof(_arena->derived) - TIME_OFFSET, "%04d-%03d-%02d:%02d:%012.9f",
+            time.year, time.doy, time.hour, time.minute, time.second);
+        std::string_view value(text, std::min((size_t)std::max(length, 0), sizeof(_arena->derived) - TIME_OFFSET - 1));
+        _arena->key_values.push_back({"TIME", value});
+        parse_time_value(value);
+        std::stable_sort(_arena->key_values.begin(), _arena->key_values.end(),
+            [](const Sim42FrameArena::KeyValue& a, const Sim42FrameArena::KeyValue& b){return a.first < b.first;});
+    }
+
+    void Sim42DataPoint::parse_time_value(std::string_view value)
+    {
+        // YEAR-DOY-HH:MM:SS.SSS, parsed left to right in one pass
+        Sim42FrameTime& time = _arena->time;
+        const char *p = value.data(), *end = value.data() + value.size();
+        const char *year = p, *doy = NULL, *hour = NULL, *minute = NULL, *second = NULL;
+        std::from_chars_result result = std::from_chars(p, end, time.year);
+        if ((result.ec == std::errc()) && (result.ptr < end) && (*result.ptr == '-')) {
+            result = std::from_chars(doy = result.ptr + 1, end, time.doy);
+        } else result.ec = std::errc::invalid_argument;
+        if ((result.ec == std::errc()) && (result.ptr < end) && (*result.ptr == '-')) {
+            result = std::from_chars(hour = result.ptr + 1, end, time.hour);
+        } else result.ec = std::errc::invalid_argument;
+        if ((result.ec == std::errc()) && (result.ptr < end) && (*result.ptr == ':')) {
+            result = std::from_chars(minute = result.ptr + 1, end, time.minute);
+        } else result.ec = std::errc::invalid_argument;
+        if ((result.ec == std::errc()) && (result.ptr < end) && (*result.ptr == ':')) {
+            result = std::from_chars(second = result.ptr + 1, end, time.second);
+        } else result.ec = std::errc::invalid_argument;
+        if (result.ec != std::errc()) {
+            sim_logger->error("Sim42DataPoint::parse_time_value:  Malformed TIME %.*s", (int)value.size(), value.data());
+            return;
+        }
+
+        long Month, Day;
+        DOY2MD(time.year, time.doy, &Month, &Day);
+        time.month = Month;
+        time.day = Day;
+        time.abs_time = DateToTime(time.year, Month, Day, time.hour, time.minute, time.second);
+        time.valid = true;
+
+        // The text values, for get_value_for_key... views of the TIME line where possible
+        _arena->key_values.push_back({"YEAR", std::string_view(year, doy - 1 - year)});
+        _arena->key_values.push_back({"DOY", std::string_view(doy, hour - 1 - doy)});
+        _arena->key_values.push_back({"HOUR", std::string_view(hour, minute - 1 - hour)});
+        _arena->key_values.push_back({"MINUTE", std::string_view(minute, second - 1 - minute)});
+        _arena->key_values.push_back({"SECOND", std::string_view(second, end - second)});
+        char *derived = _arena->derived;
+        int length = snprintf(derived + MONTH_OFFSET, DAY_OFFSET - MONTH_OFFSET, "%d", time.month);
+        _arena->key_values.push_back({"MONTH", std::string_view(derived + MONTH_OFFSET, length)});
+        length = snprintf(derived + DAY_OFFSET, ABSTIME_OFFSET - DAY_OFFSET, "%d", time.day);
+        _arena->key_values.push_back({"DAY", std::string_view(derived + DAY_OFFSET, length)});
+        length = snprintf(derived + ABSTIME_OFFSET, TIME_OFFSET - ABSTIME_OFFSET, "%.17g", time.abs_time);
+        _arena->key_values.push_back({"ABSTIME", std::string_view(derived + ABSTIME_OFFSET, length)});
+    }
+
+    bool Sim42DataPoint::find_value(std::string_view key, std::string_view& value) const
+    {
+        if (!_arena) return false;
+        std::vector<Sim42FrameArena::KeyValue>::const_iterator iter =
+            std::lower_bound(_arena->key_values.begin(), _arena->key_values.end(), key, key_less);
+        if ((iter != _arena->key_values.end()) && (iter->first == key)) {
+            value = iter->second;
+            return true;
         }
-        std::string key = "YEAR";
-        _key_values.insert({key, tokens[0]});
-        key = "DOY";
-        _key_values.insert({key, tokens[1]});
-        std::string time(tokens[2]);
+        return _arena->lazy && find_lazy_value(key, value);
+    }
 
-        tokens.clear();
-        std::istringstream iss2(time);
-        while (std::getline(iss2, token, ':')) {
-            tokens.push_back(token);
+    bool Sim42DataPoint::find_lazy_value(std::string_view key, std::string_view& value) const
+    {
+        if (key.empty()) return false;
+        std::lock_guard<std::mutex> lock(_arena->found_mutex);
+        for (std::vector<Sim42FrameArena::KeyValue>::const_iterator iter = _arena->found.begin(); iter != _arena->found.end(); iter++) {
+            if (iter->first == key) {
+                value = iter->second;
+                return true;
+            }
+        }
+        if (_arena->field_table) return format_binary_value(key, value);
+        for (std::vector<std::string_view>::const_iterator iter = _arena->lines.begin(); iter != _arena->lines.end(); iter++) {
+            std::string_view line_key;
+            if (line_has_key(*iter, key, line_key, value)) {
+                // Remembered by the view of the line, since key may not outlive this call... missing keys are not remembered
+                _arena->found.push_back({line_key, value});
+                return true;
+            }
         }
-        key = "HOUR";
-        _key_values.insert({key, tokens[0]});
-        key = "MINUTE";
-        _key_values.insert({key, tokens[1]});
-        key = "SECOND";
-        _key_values.insert({key, tokens[2]});
+        return false;
     }
 
+    bool Sim42DataPoint::format_binary_value(std::string_view key, std::string_view& value) const
+    {
+        Sim42FieldHandle handle = _arena->field_table->get_handle(key);
+        if (!handle.is_valid()) return false;
+        std::vector<double> numbers(handle.size);
+        memcpy(numbers.data(), binary_values() + handle.offset*sizeof(double), handle.size*sizeof(double));
+        // Kept in formatted, which never moves its elements, so the views stay valid while the arena is
+        _arena->formatted.push_back(std::string(key));
+        std::string_view stored_key(_arena->formatted.back());
+        _arena->formatted.push_back(format_numbers(numbers, false));
+        value = _arena->formatted.back();
+        _arena->found.push_back({stored_key, value});
+        return true;
+    }
+
+    void Sim42DataPoint::set_derived_value(std::string_view key, size_t offset, const std::string& value)
+    {
+        size_t end = (offset < TIME_OFFSET) ? TIME_OFFSET : sizeof(_arena->derived);
+        size_t length = std::min(value.size(), end - offset - 1);
+        memcpy(_arena->derived + offset, value.data(), length);
+        _arena->derived[offset + length] = '\0';
+        std::vector<Sim42FrameArena::KeyValue>::iterator iter =
+            std::lower_bound(_arena->key_values.begin(), _arena->key_values.end(), key, key_less);
+        if ((iter != _arena->key_values.end()) && (iter->first == key)) {
+            iter->second = std::string_view(_arena->derived + offset, length);
+        } else {
+            _arena->key_values.insert(iter, {key, std::string_view(_arena->derived + offset, length)});
+        }
+    }
+
+    const std::vector<std::string_view>& Sim42DataPoint::empty_lines(void)
+    {
+        static const std::vector<std::string_view> empty;
+        return empty;
+    }
+
+    /*************************************************************************
+     * Accessors
+     *************************************************************************/
+
     /**********************************************************************/
     /*  Find Month, Day, given Day of Year                                */
     /*  Ref. Jean Meeus, 'Astronomical Algorithms', QB51.3.E43M42, 1991.  */
@@ -162,34 +469,233 @@ namespace Nos3
 
     std::string Sim42DataPoint::to_string(void) const
     {
-        std::stringstream ss;
+        std::string result("42 Data Point: ");
+        if (is_binary()) {
+            std::string text;
+            format_text(text);
+            result.append(text);
+            return result;
+        }
+        const std::vector<std::string_view>& lines = get_line_views();
+        for (std::vector<std::string_view>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+            result.append(*it);
+        }
+        return result;
+    }
+
+    std::vector<std::string> Sim42DataPoint::get_lines(void) const
+    {
+        const std::vector<std::string_view>& lines = get_line_views();
+        return std::vector<std::string>(lines.begin(), lines.end());
+    }
+
+    void Sim42DataPoint::format_text(std::string& text) const
+    {
+        text.clear();
+        if (!is_binary()) {
+            text.assign(get_text());
+            return;
+        }
+        text.append("TIME ");
+        text.append(get_value_view("TIME"));
+        text.push_back('\n');
+        const Sim42Schema& table = *_arena->field_table;
+        const std::deque<std::string>& keys = table.get_keys();
+        std::vector<double> numbers;
+        for (std::deque<std::string>::const_iterator iter = keys.begin(); iter != keys.end(); iter++) {
+            Sim42FieldHandle handle = table.get_handle(*iter);
+            numbers.resize(handle.size);
+            memcpy(numbers.data(), binary_values() + handle.offset*sizeof(double), handle.size*sizeof(double));
+            text.append(*iter);
+            text.append(" = ");
+            text.append(format_numbers(numbers, false));
+            text.push_back('\n');
+        }
+        text.append("[ENDMSG]\n");
+    }
+
+    size_t Sim42DataPoint::get_doubles(std::string_view key, double *values, size_t count) const
+    {
+        if (is_binary()) {
+            Sim42FieldHandle handle = _arena->field_table->get_handle(key);
+            if (handle.is_valid()) {
+                size_t copied = std::min(count, (size_t)handle.size);
+                memcpy(values, binary_values() + handle.offset*sizeof(double), copied*sizeof(double));
+                return copied;
+            }
+        }
+        return parse_doubles(get_value_view(key), values, count);
+    }
+
+    std::string_view Sim42DataPoint::get_value_view(std::string_view key) const
+    {
+        std::string_view value;
+        find_value(key, value);
+        return value;
+    }
+
+    void Sim42DataPoint::parse_numeric_fields(Sim42NumericFields& numeric) const
+    {
+        numeric.fields.clear();
+        numeric.values.clear();
+        if (!_arena) return;
+        for (std::vector<Sim42FrameArena::KeyValue>::const_iterator iter = _arena->key_values.begin(); iter != _arena->key_values.end(); iter++) {
+            size_t offset = numeric.values.size();
+            if (parse_numbers(iter->second, numeric.values)) {
+                Sim42NumericField field = {iter->first, (uint32_t)offset, (uint32_t)(numeric.values.size() - offset)};
+                numeric.fields.push_back(field); // key_values is sorted, so fields is too
+            }
+        }
+        if (!_arena->lazy) return;
 
-        ss << std::fixed << std::setfill(' ');
-        ss << "42 Data Point: ";
-        for (std::vector<std::string>::const_iterator it = _lines.begin(); it != _lines.end(); ++it) {
-            ss << *it;
+        // Binary... the fields are copied from the frame
+        if (_arena->field_table) {
+            const Sim42Schema& table = *_arena->field_table;
+            const std::deque<std::string>& keys = table.get_keys();
+            for (std::deque<std::string>::const_iterator iter = keys.begin(); iter != keys.end(); iter++) {
+                Sim42FieldHandle handle = table.get_handle(*iter);
+                size_t offset = numeric.values.size();
+                numeric.values.resize(offset + handle.size);
+                memcpy(numeric.values.data() + offset, binary_values() + handle.offset*sizeof(double), handle.size*sizeof(double));
+                Sim42NumericField field = {*iter, (uint32_t)offset, handle.size};
+                numeric.fields.push_back(field);
+            }
+        }
+
+        // Lazy... key_values only has the TIME keys, so every other line is parsed here, then all are sorted
+        for (std::vector<std::string_view>::const_iterator iter = _arena->lines.begin(); iter != _arena->lines.end(); iter++) {
+            size_t equals = iter->find('=');
+            if (equals == std::string_view::npos) continue;
+            size_t offset = numeric.values.size();
+            if (parse_numbers(trim(iter->substr(equals+1)), numeric.values)) {
+                Sim42NumericField field = {trim(iter->substr(0, equals)), (uint32_t)offset, (uint32_t)(numeric.values.size() - offset)};
+                numeric.fields.push_back(field);
+            }
         }
-        return ss.str();
+        std::stable_sort(numeric.fields.begin(), numeric.fields.end(),
+            [](const Sim42NumericField& a, const Sim42NumericField& b){return a.key < b.key;});
     }
 
-    std::string Sim42DataPoint::get_value_for_key(std::string key) {
-        return _key_values[key];
+    const double* Sim42NumericFields::find(std::string_view key, uint32_t *size) const
+    {
+        std::vector<Sim42NumericField>::const_iterator iter = std::lower_bound(fields.begin(), fields.end(), key,
+            [](const Sim42NumericField& field, std::string_view k){return field.key < k;});
+        if ((iter == fields.end()) || (iter->key != key)) return NULL;
+        if (size != NULL) *size = iter->size;
+        return values.data() + iter->offset;
     }
 
     /*************************************************************************
      * Static methods
      *************************************************************************/
 
-    void Sim42DataPoint::parse_double_vector(const std::string& text, std::vector<double>& dv) 
+    Sim42DataPoint Sim42DataPoint::interpolate(const Sim42DataPoint& before, const Sim42DataPoint& after, double abs_time,
+        const Sim42KeyFilter *discrete)
+    {
+        if (!before._arena) return before;
+        double t0 = before.get_abs_time();
+        double t1 = after.get_abs_time();
+        double fraction = (t1 > t0) ? (abs_time - t0)/(t1 - t0) : 0.0;
+        fraction = std::min(std::max(fraction, 0.0), 1.0);
+        if (before.is_binary() || after.is_binary()) return interpolate_binary(before, after, abs_time, fraction, discrete);
+
+        // Build the text of the interpolated frame from the earlier frame, replacing interpolated values
+        boost::shared_ptr<Sim42FrameArena> arena(Sim42FrameArenaPool::Instance().acquire());
+        std::string& text = arena->text;
+        text.reserve(before._arena->frame.size() + before._arena->frame.size()/4);
+        std::vector<double> v0, v1;
+        const std::vector<std::string_view>& lines = before.get_line_views();
+        for (std::vector<std::string_view>::const_iterator iter = lines.begin(); iter != lines.end(); iter++) {
+            size_t equals = iter->find('=');
+            std::string_view key, value, other;
+            v0.clear();
+            v1.clear();
+            if (equals != std::string_view::npos) {
+                key = trim(iter->substr(0, equals));
+                value = trim(iter->substr(equals+1));
+            }
+            if ((equals == std::string_view::npos) || !after.find_value(key, other) ||
+                (is_integer_text(value) && is_integer_text(other)) || is_discrete_key(discrete, key) ||
+                !parse_numbers(value, v0) || !parse_numbers(other, v1) || (v0.size() != v1.size())) {
+                text.append(*iter);
+                text.push_back('\n');
+                continue;
+            }
+
+            if ((v0.size() == 4) && is_quaternion_key(key)) {
+                slerp(v0, v1, fraction);
+            } else {
+                for (size_t i = 0; i < v0.size(); i++) v0[i] += fraction*(v1[i] - v0[i]);
+            }
+            text.append(key);
+            text.append(" = ");
+            text.append(format_numbers(v0, value.find('[') != std::string_view::npos));
+            text.push_back('\n');
+        }
+
+        Sim42DataPoint dp(arena, before._arena->lazy);
+        dp.set_derived_value("ABSTIME", ABSTIME_OFFSET, format_numbers(std::vector<double>(1, abs_time), false));
+        arena->time.abs_time = abs_time;
+        return dp;
+    }
+
+    Sim42DataPoint Sim42DataPoint::interpolate_binary(const Sim42DataPoint& before, const Sim42DataPoint& after, double abs_time, double fraction,
+        const Sim42KeyFilter *discrete)
+    {
+        if (before._arena->field_table != after._arena->field_table) return before; // the sender changed its fields in between
+
+        // Interpolate the doubles of the earlier frame in place in a copy of its payload
+        boost::shared_ptr<Sim42FrameArena> arena(Sim42FrameArenaPool::Instance().acquire());
+        arena->text = before._arena->text;
+        arena->field_table = before._arena->field_table;
+        char *values = &arena->text[sizeof(Sim42BinaryTime)];
+        const char *other = after.binary_values();
+        const Sim42Schema& table = *arena->field_table;
+        const std::deque<std::string>& keys = table.get_keys();
+        std::vector<double> v0, v1;
+        for (std::deque<std::string>::const_iterator iter = keys.begin(); iter != keys.end(); iter++) {
+            if (is_discrete_key(discrete, *iter)) continue; // the doubles of a binary frame do not say which fields are discrete
+            Sim42FieldHandle handle = table.get_handle(*iter);
+            v0.resize(handle.size);
+            v1.resize(handle.size);
+            memcpy(v0.data(), values + handle.offset*sizeof(double), handle.size*sizeof(double));
+            memcpy(v1.data(), other + handle.offset*sizeof(double), handle.size*sizeof(double));
+
+            if ((v0.size() == 4) && is_quaternion_key(*iter)) {
+                slerp(v0, v1, fraction);
+            } else {
+                for (size_t i = 0; i < v0.size(); i++) v0[i] += fraction*(v1[i] - v0[i]);
+            }
+            memcpy(values + handle.offset*sizeof(double), v0.data(), handle.size*sizeof(double));
+        }
+
+        Sim42DataPoint dp(arena);
+        dp.set_derived_value("ABSTIME", ABSTIME_OFFSET, format_numbers(std::vector<double>(1, abs_time), false));
+        arena->time.abs_time = abs_time;
+        return dp;
+    }
+
+    void Sim42DataPoint::parse_double_vector(const std::string& text, std::vector<double>& dv)
     {
         dv.clear();
-        std::string t = text;
-        t.erase(std::remove(t.begin(), t.end(), '['), t.end());
-        t.erase(std::remove(t.begin(), t.end(), ']'), t.end());
-        std::istringstream iss(t);
-        for (std::string s; iss >> s; )
-            dv.push_back(std::stod(s));
-    }
-    
+        const char *p = text.data(), *end = text.data() + text.size();
+        double value;
+        while (parse_next(p, end, value)) dv.push_back(value);
+        while ((p < end) && is_separator(*p)) p++;
+        if (p < end) {
+            // Fail loudly, as std::stod did, rather than return the numbers before the bad text as if they were all
+            sim_logger->error("Sim42DataPoint::parse_double_vector:  Malformed number at \"%.*s\" in \"%s\"", (int)(end - p), p, text.c_str());
+            throw std::invalid_argument("Sim42DataPoint::parse_double_vector:  Malformed number in " + text);
+        }
+    }
+
+    size_t Sim42DataPoint::parse_doubles(std::string_view text, double *values, size_t count)
+    {
+        const char *p = text.data(), *end = text.data() + text.size();
+        size_t parsed = 0;
+        while ((parsed < count) && parse_next(p, end, values[parsed])) parsed++;
+        return parsed;
+    }
+
 
 }
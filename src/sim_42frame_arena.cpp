@@ -0,0 +1,65 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sim_42frame_arena.hpp>
+
+namespace Nos3
+{
+
+    Sim42FrameArenaPool& Sim42FrameArenaPool::Instance()
+    {
+        // Never destroyed, so data points released during exit can still return their arenas
+        static Sim42FrameArenaPool *pool = new Sim42FrameArenaPool();
+        return *pool;
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    boost::shared_ptr<Sim42FrameArena> Sim42FrameArenaPool::acquire(void)
+    {
+        Sim42FrameArena *arena = NULL;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_free.empty()) {
+                arena = _free.back();
+                _free.pop_back();
+            }
+        }
+        if (arena == NULL) arena = new Sim42FrameArena();
+        return boost::shared_ptr<Sim42FrameArena>(arena, [this](Sim42FrameArena *a){release(a);});
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    void Sim42FrameArenaPool::release(Sim42FrameArena *arena)
+    {
+        arena->clear();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_free.size() < MAX_POOLED) {
+                _free.push_back(arena);
+                return;
+            }
+        }
+        delete arena;
+    }
+
+}
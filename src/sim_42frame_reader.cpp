@@ -0,0 +1,187 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42binary_frame.hpp>
+#include <sim_42frame_reader.hpp>
+
+namespace Nos3
+{
+
+    extern ItcLogger::Logger *sim_logger;
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Sim42FrameReader::Sim42FrameReader(size_t initial_capacity)
+        : _socket_fd(-1), _buffer(initial_capacity > 0 ? initial_capacity : 1), _head(0), _tail(0),
+          _total_bytes(0), _total_frames(0), _window_bytes(0), _window_frames(0),
+          _window_start(std::chrono::steady_clock::now()), _bytes_per_second(0.0), _frames_per_second(0.0)
+    {
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    void Sim42FrameReader::reset(int socket_fd)
+    {
+        _socket_fd = socket_fd;
+        _head = 0;
+        _tail = 0;
+        _total_bytes = 0;
+        _total_frames = 0;
+        _window_bytes = 0;
+        _window_frames = 0;
+        _window_start = std::chrono::steady_clock::now();
+        _bytes_per_second = 0.0;
+        _frames_per_second = 0.0;
+    }
+
+    bool Sim42FrameReader::read_frame(std::string& frame, const Sim42KeyFilter *filter)
+    {
+        frame.clear();
+        size_t scanned = _head; // do not rescan the partial line after each fill
+        bool trace_lines = sim_logger->is_level_enabled(ItcLogger::LOGGER_TRACE); // checked once per frame, not per line
+
+        while (true)
+        {
+            char *base = _buffer.data();
+            char *newline = static_cast<char *>(memchr(base + scanned, '\n', _tail - scanned));
+            if (newline != NULL)
+            {
+                size_t line_end = newline - base;
+                const char *line = base + _head;
+                size_t line_length = line_end - _head;
+                bool end_of_frame = (line_length >= 8) && (memcmp(line, "[ENDMSG]", 8) == 0);
+                if (end_of_frame || (filter == NULL) || filter->matches(line, line_length)) frame.append(line, line_length + 1);
+                _head = line_end + 1;
+                scanned = _head;
+                if (trace_lines) sim_logger->trace("Sim42FrameReader::read_frame:  Line=%.*s", (int)line_length, line);
+                if (end_of_frame)
+                {
+                    _total_frames++;
+                    _window_frames++;
+                    update_rates();
+                    return true;
+                }
+            }
+            else
+            {
+                size_t consumed = _head;
+                scanned = _tail;
+                if (!fill_buffer()) return false;
+                scanned -= consumed; // fill_buffer moves unconsumed data to the front of the buffer
+            }
+        }
+    }
+
+    bool Sim42FrameReader::read_message(std::string& payload, uint32_t& type)
+    {
+        payload.clear();
+        Sim42BinaryHeader header;
+        while (_tail - _head < sizeof(header)) {
+            if (!fill_buffer()) return false;
+        }
+        memcpy(&header, _buffer.data() + _head, sizeof(header));
+        if ((memcmp(header.magic, SIM42BIN_MAGIC, sizeof(header.magic)) != 0) || (header.length > SIM42BIN_MAX_LENGTH))
+        {
+            sim_logger->error("Sim42FrameReader::read_message:  Socket %d is not a binary 42 stream, or is corrupt (message %u, length %u)",
+                _socket_fd, header.sequence, header.length);
+            return false;
+        }
+        while (_tail - _head < sizeof(header) + header.length) {
+            if (!fill_buffer()) return false;
+        }
+
+        payload.assign(_buffer.data() + _head + sizeof(header), header.length);
+        _head += sizeof(header) + header.length;
+        type = header.type;
+        if (type == SIM42BIN_DATA) {
+            _total_frames++;
+            _window_frames++;
+            update_rates();
+        }
+        return true;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    bool Sim42FrameReader::fill_buffer(void)
+    {
+        // Move any partial line (or message) to the front of the buffer... grow the buffer if it fills it
+        if (_head > 0)
+        {
+            memmove(_buffer.data(), _buffer.data() + _head, _tail - _head);
+            _tail -= _head;
+            _head = 0;
+        }
+        if (_tail == _buffer.size())
+        {
+            _buffer.resize(_buffer.size() * 2);
+            sim_logger->debug("Sim42FrameReader::fill_buffer:  Line or message longer than receive buffer, grew buffer to %lu bytes", _buffer.size());
+        }
+
+        ssize_t bytes_read;
+        do
+        {
+            bytes_read = recv(_socket_fd, _buffer.data() + _tail, _buffer.size() - _tail, 0);
+        } while ((bytes_read < 0) && (errno == EINTR));
+
+        if (bytes_read < 0)
+        {
+            sim_logger->error("Sim42FrameReader::fill_buffer:  Error reading socket %d: %s", _socket_fd, strerror(errno));
+            return false;
+        }
+        else if (bytes_read == 0)
+        {
+            sim_logger->info("Sim42FrameReader::fill_buffer:  Socket %d closed by peer", _socket_fd);
+            return false;
+        }
+
+        _tail += bytes_read;
+        _total_bytes += bytes_read;
+        _window_bytes += bytes_read;
+        update_rates();
+        return true;
+    }
+
+    void Sim42FrameReader::update_rates(void)
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - _window_start).count();
+        if (elapsed >= 1.0)
+        {
+            _bytes_per_second = _window_bytes / elapsed;
+            _frames_per_second = _window_frames / elapsed;
+            sim_logger->debug("Sim42FrameReader::update_rates:  Socket %d receiving %.0f bytes/s, %.2f frames/s",
+                _socket_fd, _bytes_per_second.load(), _frames_per_second.load());
+            _window_bytes = 0;
+            _window_frames = 0;
+            _window_start = now;
+        }
+    }
+
+}
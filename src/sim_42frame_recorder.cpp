@@ -0,0 +1,179 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42frame_recorder.hpp>
+
+namespace Nos3
+{
+
+    extern ItcLogger::Logger *sim_logger;
+
+    std::mutex Sim42FrameRecorder::_paths_mutex;
+    std::set<std::string> Sim42FrameRecorder::_paths;
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Sim42FrameRecorder::Sim42FrameRecorder(const std::string& filename)
+        : _filename(filename), _fd(-1), _data(NULL), _capacity(0), _used(0), _frame_count(0)
+    {
+        if (!claim(_filename, _path))
+        {
+            sim_logger->error("Sim42FrameRecorder::Sim42FrameRecorder:  42 frame log %s is already being recorded, not recording to it again", _filename.c_str());
+            return;
+        }
+        _fd = open(_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0)
+        {
+            sim_logger->error("Sim42FrameRecorder::Sim42FrameRecorder:  Unable to open 42 frame log %s: %s", _filename.c_str(), strerror(errno));
+            return;
+        }
+        if (!map(CHUNK_SIZE)) return;
+
+        Sim42FrameLogHeader header;
+        memcpy(header.magic, SIM42LOG_MAGIC, sizeof(header.magic));
+        header.version = SIM42LOG_VERSION;
+        header.header_size = sizeof(Sim42FrameLogHeader);
+        memcpy(_data, &header, sizeof(header));
+        _used = sizeof(header);
+        sim_logger->info("Sim42FrameRecorder::Sim42FrameRecorder:  Recording 42 frames to %s", _filename.c_str());
+    }
+
+    Sim42FrameRecorder::~Sim42FrameRecorder(void)
+    {
+        if (_data != NULL) munmap(_data, _capacity);
+        if (_fd >= 0)
+        {
+            if (ftruncate(_fd, _used) != 0)
+            {
+                sim_logger->error("Sim42FrameRecorder::~Sim42FrameRecorder:  Unable to truncate 42 frame log %s: %s", _filename.c_str(), strerror(errno));
+            }
+            close(_fd);
+            sim_logger->info("Sim42FrameRecorder::~Sim42FrameRecorder:  Recorded %lu 42 frames, %lu bytes, to %s", _frame_count, _used, _filename.c_str());
+        }
+        if (!_path.empty())
+        {
+            std::lock_guard<std::mutex> lock(_paths_mutex);
+            _paths.erase(_path);
+        }
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    void Sim42FrameRecorder::record(const Sim42DataPoint& dp)
+    {
+        std::string formatted;
+        std::string_view text(dp.get_text());
+        if (dp.is_binary()) { // logs hold ASCII frames
+            dp.format_text(formatted);
+            text = formatted;
+        }
+        bool add_newline = !text.empty() && (text.back() != '\n'); // every line ends with a new line in the log
+        size_t length = text.size() + (add_newline ? 1 : 0);
+        size_t padded = (sizeof(Sim42FrameLogRecord) + length + 7) & ~(size_t)7;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_data == NULL) return;
+        if ((_used + padded > _capacity) && !map(std::max(_capacity * 2, _used + padded)))
+        {
+            return;
+        }
+
+        Sim42FrameLogRecord record;
+        record.length = length;
+        record.reserved = 0;
+        record.receive_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        record.abs_time = dp.get_abs_time();
+
+        char *out = _data + _used;
+        memcpy(out, &record, sizeof(record));
+        out += sizeof(record);
+        memcpy(out, text.data(), text.size());
+        out += text.size();
+        if (add_newline) *out++ = '\n';
+        memset(out, 0, _data + _used + padded - out);
+        _used += padded;
+        _frame_count++;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    bool Sim42FrameRecorder::claim(const std::string& filename, std::string& path)
+    {
+        // Compare absolute paths, so different spellings of one file are caught... the file need not exist yet, its directory must
+        std::string directory(".");
+        std::string name(filename);
+        size_t slash = filename.rfind('/');
+        if (slash != std::string::npos)
+        {
+            directory = (slash == 0) ? "/" : filename.substr(0, slash);
+            name = filename.substr(slash + 1);
+        }
+        char resolved[PATH_MAX];
+        path = (realpath(directory.c_str(), resolved) != NULL) ? std::string(resolved) + "/" + name : filename;
+
+        std::lock_guard<std::mutex> lock(_paths_mutex);
+        if (!_paths.insert(path).second)
+        {
+            path.clear(); // claimed by another recorder, which releases it
+            return false;
+        }
+        return true;
+    }
+
+    bool Sim42FrameRecorder::map(size_t capacity)
+    {
+        capacity = ((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE) * CHUNK_SIZE;
+        if (_data != NULL)
+        {
+            munmap(_data, _capacity);
+            _data = NULL;
+        }
+        if (ftruncate(_fd, capacity) != 0)
+        {
+            sim_logger->error("Sim42FrameRecorder::map:  Unable to grow 42 frame log %s to %lu bytes, recording stopped: %s", _filename.c_str(), capacity, strerror(errno));
+            return false;
+        }
+        void *data = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (data == MAP_FAILED)
+        {
+            sim_logger->error("Sim42FrameRecorder::map:  Unable to map 42 frame log %s, recording stopped: %s", _filename.c_str(), strerror(errno));
+            return false;
+        }
+        _data = static_cast<char *>(data);
+        _capacity = capacity;
+        return true;
+    }
+
+}
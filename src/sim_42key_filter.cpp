@@ -0,0 +1,119 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <cstring>
+
+#include <boost/foreach.hpp>
+
+#include <sim_42key_filter.hpp>
+
+namespace Nos3
+{
+
+    /*************************************************************************
+     * Constructors
+     *************************************************************************/
+
+    Sim42KeyFilter::Sim42KeyFilter(const boost::property_tree::ptree& filter)
+    {
+        BOOST_FOREACH(const boost::property_tree::ptree::value_type &v, filter)
+        {
+            if (v.first.compare("pattern") == 0)
+            {
+                add_pattern(v.second.get_value<std::string>());
+            }
+        }
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    void Sim42KeyFilter::add_pattern(const std::string& pattern)
+    {
+        std::string text(pattern);
+        while (!text.empty() && (text.back() == '*')) text.pop_back(); // patterns match key prefixes anyway
+        if (text.empty()) return; // would match every key... leave the filter as is
+        for (std::vector<Pattern>::const_iterator iter = _patterns.begin(); iter != _patterns.end(); iter++) {
+            if (iter->text == text) return;
+        }
+        Pattern p = {text, text.find('*') != std::string::npos};
+        _patterns.push_back(p);
+    }
+
+    void Sim42KeyFilter::add_patterns(const Sim42KeyFilter& other)
+    {
+        for (std::vector<Pattern>::const_iterator iter = other._patterns.begin(); iter != other._patterns.end(); iter++) {
+            add_pattern(iter->text);
+        }
+    }
+
+    /*************************************************************************
+     * Accessors
+     *************************************************************************/
+
+    bool Sim42KeyFilter::matches(const char *line, size_t length) const
+    {
+        if (_patterns.empty()) return true;
+
+        while ((length > 0) && ((*line == ' ') || (*line == '\t'))) {
+            line++;
+            length--;
+        }
+        if ((length >= 4) && (memcmp(line, "TIME", 4) == 0) && ((length == 4) || (line[4] == ' ') || (line[4] == '\t'))) return true;
+
+        size_t key_length = 0; // found only if a wildcard pattern needs it
+        for (std::vector<Pattern>::const_iterator iter = _patterns.begin(); iter != _patterns.end(); iter++) {
+            if (!iter->has_wildcard) {
+                if ((length >= iter->text.size()) && (memcmp(line, iter->text.data(), iter->text.size()) == 0)) return true;
+            } else {
+                if (key_length == 0) {
+                    const char *equals = static_cast<const char *>(memchr(line, '=', length));
+                    key_length = (equals != NULL) ? equals - line : length;
+                }
+                if (match_wildcards(iter->text, line, key_length)) return true;
+            }
+        }
+        return false;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    bool Sim42KeyFilter::match_wildcards(const std::string& pattern, const char *key, size_t length)
+    {
+        size_t p = 0, k = 0;
+        size_t star = std::string::npos, resume = 0; // the last * seen, and where its match would be extended from
+        while (p < pattern.size()) {
+            if (pattern[p] == '*') {
+                star = p++;
+                resume = k;
+            } else if ((k < length) && (pattern[p] == key[k])) {
+                p++;
+                k++;
+            } else if ((star != std::string::npos) && (resume < length)) {
+                p = star + 1; // let the * match one more character and try again
+                k = ++resume;
+            } else {
+                return false;
+            }
+        }
+        return true; // the whole pattern matched the start of the key
+    }
+
+}
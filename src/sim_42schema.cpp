@@ -0,0 +1,152 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+#include <boost/foreach.hpp>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_42binary_frame.hpp>
+#include <sim_42data_point.hpp>
+#include <sim_42schema.hpp>
+
+namespace Nos3
+{
+
+    extern ItcLogger::Logger *sim_logger;
+
+    /*************************************************************************
+     * Constructors
+     *************************************************************************/
+
+    Sim42Schema::Sim42Schema(const boost::property_tree::ptree& schema) : _value_count(0)
+    {
+        BOOST_FOREACH(const boost::property_tree::ptree::value_type &v, schema)
+        {
+            if (v.first.compare("field") == 0)
+            {
+                std::string key = v.second.get("key", "");
+                if (key.compare("") != 0)
+                {
+                    add_field(key, v.second.get("size", 1u));
+                }
+            }
+        }
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    Sim42FieldHandle Sim42Schema::add_field(const std::string& key, uint32_t size)
+    {
+        if (size == 0)
+        {
+            sim_logger->error("Sim42Schema::add_field:  Key %s has size 0, ignoring it", key.c_str());
+            Sim42FieldHandle invalid = {0, 0};
+            return invalid;
+        }
+
+        std::unordered_map<std::string_view, Sim42FieldHandle>::const_iterator iter = _fields.find(key);
+        if (iter != _fields.end())
+        {
+            if (iter->second.size != size)
+            {
+                sim_logger->warning("Sim42Schema::add_field:  Key %s already has size %u, ignoring size %u", key.c_str(), iter->second.size, size);
+            }
+            return iter->second;
+        }
+
+        Sim42FieldHandle handle = {_value_count, size};
+        _keys.push_back(key);
+        _fields.insert({std::string_view(_keys.back()), handle});
+        _value_count += size;
+        sim_logger->debug("Sim42Schema::add_field:  Key %s compiled to slots %u-%u", key.c_str(), handle.offset, handle.offset + size - 1);
+        return handle;
+    }
+
+    bool Sim42Schema::add_binary_field_table(const char *table, size_t length)
+    {
+        const char *p = table, *end = table + length;
+        uint32_t count;
+        if ((size_t)(end - p) < sizeof(count)) return false;
+        memcpy(&count, p, sizeof(count));
+        p += sizeof(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t size, key_length;
+            if ((size_t)(end - p) < sizeof(size) + sizeof(key_length)) return false;
+            memcpy(&size, p, sizeof(size));
+            memcpy(&key_length, p + sizeof(size), sizeof(key_length));
+            p += sizeof(size) + sizeof(key_length);
+            if (((size_t)(end - p) < key_length) || (size == 0)) return false;
+            if (((uint64_t)_value_count + size)*sizeof(double) + sizeof(Sim42BinaryTime) > SIM42BIN_MAX_LENGTH) return false; // nor can the values overflow a data message
+
+            std::string key(p, key_length);
+            p += key_length;
+            size_t fields = _keys.size();
+            add_field(key, size);
+            if (_keys.size() == fields) return false; // a repeated key would misalign the values
+        }
+        return p == end;
+    }
+
+    /*************************************************************************
+     * Accessors
+     *************************************************************************/
+
+    Sim42FieldHandle Sim42Schema::get_handle(std::string_view key) const
+    {
+        std::unordered_map<std::string_view, Sim42FieldHandle>::const_iterator iter = _fields.find(key);
+        if (iter == _fields.end())
+        {
+            Sim42FieldHandle invalid = {0, 0};
+            return invalid;
+        }
+        return iter->second;
+    }
+
+    void Sim42Schema::parse(const std::vector<std::string_view>& lines, double *values) const
+    {
+        std::fill(values, values + _value_count, std::numeric_limits<double>::quiet_NaN());
+
+        for (std::vector<std::string_view>::const_iterator iter = lines.begin(); iter != lines.end(); iter++) {
+            size_t equals = iter->find('=');
+            if (equals == std::string_view::npos) continue;
+
+            // Trim the key in place
+            const char *line = iter->data();
+            const char *line_end = line + iter->size();
+            size_t key_begin = 0, key_end = equals;
+            while ((key_begin < key_end) && isspace((unsigned char)line[key_begin])) key_begin++;
+            while ((key_end > key_begin) && isspace((unsigned char)line[key_end - 1])) key_end--;
+
+            std::unordered_map<std::string_view, Sim42FieldHandle>::const_iterator field =
+                _fields.find(std::string_view(line + key_begin, key_end - key_begin));
+            if (field == _fields.end()) continue;
+
+            // Numbers are separated by white space and may be in brackets, e.g. [1.0 2.0 3.0]... elements not parsed stay NaN
+            Sim42DataPoint::parse_doubles(std::string_view(line + equals + 1, line_end - (line + equals + 1)),
+                values + field->second.offset, field->second.size);
+        }
+    }
+
+}
@@ -0,0 +1,485 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_config.hpp>
+#include <sim_42binary_frame.hpp>
+#include "sim_42standin.hpp"
+
+namespace Nos3
+{
+    ItcLogger::Logger *sim_logger;
+
+    namespace
+    {
+        const double ORBIT_RADIUS = 6778.0e3;     // m, about 400 km altitude
+        const double EARTH_MU = 3.986004418e14;   // m^3/s^2
+        const time_t J2000_UNIX_TIME = 946728000; // 2000-01-01 12:00:00
+
+        int64_t steady_time_ns(void)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // Name and number of values of a key of a spacecraft
+        int key_layout(int sc, int key, char *name, size_t name_size)
+        {
+            switch (key) {
+            case 0:
+                snprintf(name, name_size, "SC[%d].PosN", sc);
+                return 3;
+            case 1:
+                snprintf(name, name_size, "SC[%d].VelN", sc);
+                return 3;
+            case 2:
+                snprintf(name, name_size, "SC[%d].qn", sc);
+                return 4;
+            case 3:
+                snprintf(name, name_size, "SC[%d].wn", sc);
+                return 3;
+            default:
+                snprintf(name, name_size, "SC[%d].Key[%d]", sc, key - 4);
+                return 1;
+            }
+        }
+
+        // Appends a binary message header for a payload of length bytes
+        void append_header(std::string& message, uint32_t type, uint32_t length, uint32_t sequence)
+        {
+            Sim42BinaryHeader header;
+            memcpy(header.magic, SIM42BIN_MAGIC, sizeof(header.magic));
+            header.type = type;
+            header.length = length;
+            header.sequence = sequence;
+            message.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
+
+        // Appends a line to the frame, printf style
+        void append_line(std::string& frame, const char *format, ...) __attribute__((format(printf, 2, 3)));
+        void append_line(std::string& frame, const char *format, ...)
+        {
+            char line[256];
+            va_list args;
+            va_start(args, format);
+            int length = vsnprintf(line, sizeof(line), format, args);
+            va_end(args);
+            frame.append(line, std::min<size_t>(length, sizeof(line) - 1));
+            frame.push_back('\n');
+        }
+    }
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Sim42StandIn::Sim42StandIn(const Sim42StandInOptions& options)
+        : _options(options), _stopped(false), _telemetry_listener_fd(-1), _command_listener_fd(-1),
+          _frames_sent(0), _bytes_sent(0), _commands_received(0)
+    {
+        if (_options.command_log.compare("") != 0) {
+            _command_log.open(_options.command_log.c_str(), std::ios::out | std::ios::trunc);
+            if (!_command_log) {
+                sim_logger->error("Sim42StandIn::Sim42StandIn:  Unable to open command log %s", _options.command_log.c_str());
+            }
+        }
+        if (_options.binary) build_field_table();
+    }
+
+    Sim42StandIn::~Sim42StandIn(void)
+    {
+        for (std::vector<int>::const_iterator iter = _telemetry_clients.begin(); iter != _telemetry_clients.end(); iter++) {
+            close(*iter);
+        }
+        for (std::vector<CommandClient>::const_iterator iter = _command_clients.begin(); iter != _command_clients.end(); iter++) {
+            close(iter->fd);
+        }
+        if (_telemetry_listener_fd >= 0) close(_telemetry_listener_fd);
+        if (_command_listener_fd >= 0) close(_command_listener_fd);
+    }
+
+    /*************************************************************************
+     * Mutators
+     *************************************************************************/
+
+    bool Sim42StandIn::run(void)
+    {
+        _telemetry_listener_fd = open_listener(_options.telemetry_port);
+        if (_telemetry_listener_fd < 0) return false;
+        if (_options.command_port != 0) {
+            _command_listener_fd = open_listener(_options.command_port);
+            if (_command_listener_fd < 0) return false;
+        }
+        sim_logger->info("Sim42StandIn::run:  Serving %d spacecraft x %d keys at %f %s frames per second on port %u, commands on port %u",
+            _options.spacecraft, _options.keys, _options.rate, _options.binary ? "binary" : "ASCII", _options.telemetry_port, _options.command_port);
+
+        std::thread command_thread;
+        if (_command_listener_fd >= 0) command_thread = std::thread(&Sim42StandIn::serve_commands, this);
+
+        std::chrono::steady_clock::time_point start, report = std::chrono::steady_clock::now();
+        uint64_t paced_frames = 0, report_frames = 0, report_bytes = 0;
+        while (!_stopped && ((_options.frames == 0) || (_frames_sent < _options.frames)))
+        {
+            accept_telemetry_clients();
+            if (_telemetry_clients.empty()) {
+                // Time stands still until someone is listening... restart the pacing when they arrive
+                struct pollfd pfd = {_telemetry_listener_fd, POLLIN, 0};
+                poll(&pfd, 1, 100);
+                start = std::chrono::steady_clock::now();
+                paced_frames = 0;
+                continue;
+            }
+
+            if (_options.rate > 0.0) {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(paced_frames / _options.rate)));
+            }
+            build_frame(_frames_sent);
+            send_frame();
+            paced_frames++;
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - report).count();
+            if (elapsed >= 1.0) {
+                sim_logger->info("Sim42StandIn::run:  %f frames per second, %f bytes per second, %d clients, %lu commands received",
+                    (_frames_sent - report_frames)/elapsed, (_bytes_sent - report_bytes)/elapsed, (int)_telemetry_clients.size(),
+                    (uint64_t)_commands_received);
+                report = now;
+                report_frames = _frames_sent;
+                report_bytes = _bytes_sent;
+            }
+        }
+
+        _stopped = true;
+        if (command_thread.joinable()) command_thread.join();
+        sim_logger->info("Sim42StandIn::run:  Sent %lu frames, %lu bytes, received %lu commands",
+            (uint64_t)_frames_sent, (uint64_t)_bytes_sent, (uint64_t)_commands_received);
+        return true;
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    int Sim42StandIn::open_listener(uint16_t port)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            sim_logger->error("Sim42StandIn::open_listener:  Unable to create socket: %s", strerror(errno));
+            return -1;
+        }
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+        struct sockaddr_in server;
+        memset(&server, 0, sizeof(server));
+        server.sin_family = AF_INET;
+        server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        server.sin_port = htons(port);
+        if ((bind(fd, (sockaddr*)&server, sizeof(server)) != 0) || (listen(fd, 16) != 0)) {
+            sim_logger->error("Sim42StandIn::open_listener:  Unable to listen on port %u: %s", port, strerror(errno));
+            close(fd);
+            return -1;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        return fd;
+    }
+
+    void Sim42StandIn::accept_telemetry_clients(void)
+    {
+        int client_fd;
+        while ((client_fd = accept(_telemetry_listener_fd, NULL, NULL)) >= 0) {
+            int enable = 1;
+            setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+            if (!_field_table.empty() && !send_all(client_fd, _field_table)) { // binary clients need the fields before any data
+                close(client_fd);
+                continue;
+            }
+            _telemetry_clients.push_back(client_fd);
+            sim_logger->info("Sim42StandIn::accept_telemetry_clients:  Telemetry client connected, fd=%d", client_fd);
+        }
+    }
+
+    void Sim42StandIn::build_field_table(void)
+    {
+        std::string table;
+        uint32_t count = 1 + _options.spacecraft*_options.keys;
+        table.append(reinterpret_cast<const char *>(&count), sizeof(count));
+        char name[64];
+        for (int i = -1; i < _options.spacecraft*_options.keys; i++) {
+            uint32_t size = 1;
+            if (i < 0) snprintf(name, sizeof(name), "STANDIN.SendTimeNs");
+            else size = key_layout(i / _options.keys, i % _options.keys, name, sizeof(name));
+            uint32_t key_length = strlen(name);
+            table.append(reinterpret_cast<const char *>(&size), sizeof(size));
+            table.append(reinterpret_cast<const char *>(&key_length), sizeof(key_length));
+            table.append(name, key_length);
+        }
+        _field_table.clear();
+        append_header(_field_table, SIM42BIN_FIELD_TABLE, table.size(), 0);
+        _field_table.append(table);
+    }
+
+    void Sim42StandIn::build_frame(uint64_t frame_number)
+    {
+        double sim_time = _options.start_time + frame_number * _options.time_step;
+        double whole_seconds = floor(sim_time);
+        time_t unix_time = J2000_UNIX_TIME + (time_t)whole_seconds;
+        struct tm date;
+        gmtime_r(&unix_time, &date);
+
+        _frame.clear();
+        if (_options.binary) {
+            Sim42BinaryTime time = {date.tm_year + 1900, date.tm_yday + 1, date.tm_hour, date.tm_min, date.tm_sec + (sim_time - whole_seconds)};
+            append_header(_frame, SIM42BIN_DATA, 0, (uint32_t)(frame_number + 1)); // length is filled in below
+            _frame.append(reinterpret_cast<const char *>(&time), sizeof(time));
+            double send_time = (double)steady_time_ns();
+            _frame.append(reinterpret_cast<const char *>(&send_time), sizeof(send_time));
+        } else {
+            append_line(_frame, "TIME %04d-%03d-%02d:%02d:%012.9f", date.tm_year + 1900, date.tm_yday + 1, date.tm_hour, date.tm_min,
+                date.tm_sec + (sim_time - whole_seconds));
+            append_line(_frame, "STANDIN.SendTimeNs = %ld", (long)steady_time_ns());
+        }
+
+        double mean_motion = sqrt(EARTH_MU/(ORBIT_RADIUS*ORBIT_RADIUS*ORBIT_RADIUS));
+        char name[64];
+        for (int sc = 0; sc < _options.spacecraft; sc++) {
+            double theta = mean_motion*(sim_time - _options.start_time) + 2.0*M_PI*sc/_options.spacecraft;
+            double c = cos(theta), s = sin(theta);
+            for (int key = 0; key < _options.keys; key++) {
+                int count = key_layout(sc, key, name, sizeof(name));
+                double values[4];
+                switch (key) {
+                case 0:
+                    values[0] = ORBIT_RADIUS*c; values[1] = ORBIT_RADIUS*s; values[2] = 0.0;
+                    break;
+                case 1:
+                    values[0] = -ORBIT_RADIUS*mean_motion*s; values[1] = ORBIT_RADIUS*mean_motion*c; values[2] = 0.0;
+                    break;
+                case 2:
+                    values[0] = 0.0; values[1] = 0.0; values[2] = sin(theta/2.0); values[3] = cos(theta/2.0);
+                    break;
+                case 3:
+                    values[0] = 0.0; values[1] = 0.0; values[2] = mean_motion;
+                    break;
+                default:
+                    values[0] = key + sin(theta);
+                    break;
+                }
+                append_field(name, values, count);
+            }
+        }
+
+        if (_options.binary) {
+            uint32_t length = _frame.size() - sizeof(Sim42BinaryHeader);
+            memcpy(&_frame[offsetof(Sim42BinaryHeader, length)], &length, sizeof(length));
+        } else {
+            _frame.append("[ENDMSG]\n");
+        }
+    }
+
+    void Sim42StandIn::append_field(const char *key, const double *values, int count)
+    {
+        if (_options.binary) {
+            _frame.append(reinterpret_cast<const char *>(values), count*sizeof(double));
+            return;
+        }
+        _frame.append(key);
+        _frame.append(" =");
+        char value[32];
+        for (int i = 0; i < count; i++) {
+            int length = snprintf(value, sizeof(value), " %.15e", values[i]);
+            _frame.append(value, std::min<size_t>(length, sizeof(value) - 1));
+        }
+        _frame.push_back('\n');
+    }
+
+    void Sim42StandIn::send_frame(void)
+    {
+        for (std::vector<int>::iterator iter = _telemetry_clients.begin(); iter != _telemetry_clients.end(); ) {
+            if (!send_all(*iter, _frame)) {
+                sim_logger->info("Sim42StandIn::send_frame:  Telemetry client disconnected, fd=%d", *iter);
+                close(*iter);
+                iter = _telemetry_clients.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+        _frames_sent++;
+        _bytes_sent += _frame.size();
+    }
+
+    bool Sim42StandIn::send_all(int fd, const std::string& data)
+    {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t result = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            sent += result;
+        }
+        return true;
+    }
+
+    void Sim42StandIn::serve_commands(void)
+    {
+        char buffer[4096];
+        std::vector<struct pollfd> pfds;
+        while (!_stopped)
+        {
+            pfds.clear();
+            pfds.push_back({_command_listener_fd, POLLIN, 0});
+            for (std::vector<CommandClient>::const_iterator iter = _command_clients.begin(); iter != _command_clients.end(); iter++) {
+                pfds.push_back({iter->fd, POLLIN, 0});
+            }
+            if (poll(pfds.data(), pfds.size(), 100) <= 0) continue; // time out to check for stop
+
+            // Service existing clients first, new clients are added after pfds is done with
+            for (size_t i = pfds.size() - 1; i > 0; i--) {
+                if (pfds[i].revents == 0) continue;
+                CommandClient& client = _command_clients[i - 1];
+                ssize_t bytes_read = recv(client.fd, buffer, sizeof(buffer), 0);
+                if ((bytes_read < 0) && (errno == EINTR)) continue;
+                if (bytes_read <= 0) {
+                    if (!client.partial.empty()) record_command(client.partial);
+                    sim_logger->info("Sim42StandIn::serve_commands:  Command client disconnected, fd=%d", client.fd);
+                    close(client.fd);
+                    _command_clients.erase(_command_clients.begin() + (i - 1));
+                    continue;
+                }
+                client.partial.append(buffer, bytes_read);
+                size_t newline;
+                while ((newline = client.partial.find('\n')) != std::string::npos) {
+                    record_command(client.partial.substr(0, newline));
+                    client.partial.erase(0, newline + 1);
+                }
+            }
+
+            if (pfds[0].revents != 0) {
+                int client_fd;
+                while ((client_fd = accept(_command_listener_fd, NULL, NULL)) >= 0) {
+                    _command_clients.push_back({client_fd, std::string()});
+                    sim_logger->info("Sim42StandIn::serve_commands:  Command client connected, fd=%d", client_fd);
+                }
+            }
+        }
+    }
+
+    void Sim42StandIn::record_command(const std::string& command)
+    {
+        _commands_received++;
+        sim_logger->debug("Sim42StandIn::record_command:  Command %s", command.c_str());
+        if (_command_log.is_open()) {
+            _command_log << steady_time_ns() << " " << command << std::endl;
+        }
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+Nos3::Sim42StandIn* standin;
+
+void signal_handler(__attribute__((unused)) int signum)
+{
+    if (standin != NULL) standin->stop();
+}
+
+int main(int argc, char *argv[])
+{
+    Nos3::Sim42StandInOptions options;
+    std::string log_config_filename;
+    try
+    {
+        boost::program_options::options_description generic("Options");
+        generic.add_options()
+        ("help,h", "produce help message")
+        ("telemetry-port,t", boost::program_options::value<uint16_t>(&options.telemetry_port)->default_value(4242), "port frames are sent on")
+        ("command-port,c", boost::program_options::value<uint16_t>(&options.command_port)->default_value(4243), "port commands are received on, 0 for none")
+        ("spacecraft,n", boost::program_options::value<int>(&options.spacecraft)->default_value(1), "number of spacecraft in each frame")
+        ("keys,k", boost::program_options::value<int>(&options.keys)->default_value(4), "number of keys per spacecraft in each frame")
+        ("rate,r", boost::program_options::value<double>(&options.rate)->default_value(10.0), "frames per second, 0 for as fast as possible")
+        ("time-step", boost::program_options::value<double>(&options.time_step)->default_value(0.1), "simulation seconds between frames")
+        ("start-time", boost::program_options::value<double>(&options.start_time)->default_value(552110400.0), "simulation time of the first frame, seconds since J2000")
+        ("frames", boost::program_options::value<uint64_t>(&options.frames)->default_value(0), "number of frames to send, 0 for no limit")
+        ("command-log", boost::program_options::value<std::string>(&options.command_log)->default_value(""), "file the received commands are recorded to")
+        ("binary", boost::program_options::bool_switch(&options.binary), "send the binary stream rather than ASCII frames")
+        ("log-config-file,l", boost::program_options::value<std::string>(&log_config_filename)->default_value("sim_log_config.xml"), "specify log configuration file name")
+        ;
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, generic), vm);
+        boost::program_options::notify(vm);
+        if (vm.count("help")) {
+            std::cout << generic << std::endl;
+            return 1;
+        }
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "main:  Error during option parsing.  Error:  " << e.what() << std::endl << "Try --help" << std::endl;
+        return 4;
+    }
+
+    if (boost::filesystem::exists(log_config_filename))
+    {
+        ItcLogger::Logger::configure(log_config_filename.c_str());
+    }
+    Nos3::sim_logger = ItcLogger::Logger::get(SIM_LOGGER);
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    Nos3::sim_logger->info("main:  42 stand in starting");
+    standin = new Nos3::Sim42StandIn(options);
+    bool ok = standin->run();
+    std::cout << "Sent " << standin->get_frames_sent() << " frames, " << standin->get_bytes_sent() << " bytes, received "
+              << standin->get_commands_received() << " commands" << std::endl;
+    Nos3::Sim42StandIn* done = standin;
+    standin = NULL;
+    delete done;
+    Nos3::sim_logger->info("main:  42 stand in terminating");
+    return ok ? 0 : 2;
+}
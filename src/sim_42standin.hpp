@@ -0,0 +1,126 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#ifndef NOS3_SIM42STANDIN_HPP
+#define NOS3_SIM42STANDIN_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Nos3
+{
+    /// \brief Settings of a Sim42StandIn
+    struct Sim42StandInOptions
+    {
+        uint16_t telemetry_port;       // port frames are sent on
+        uint16_t command_port;         // port commands are received on, 0 for none
+        int spacecraft;                // number of spacecraft in each frame
+        int keys;                      // number of keys per spacecraft in each frame
+        double rate;                   // frames per second, 0 for as fast as possible
+        double time_step;              // simulation seconds between frames
+        double start_time;             // simulation time of the first frame, seconds since J2000
+        uint64_t frames;               // number of frames to send, 0 for no limit
+        std::string command_log;       // file the received commands are recorded to, empty for none
+        bool binary;                   // send the binary stream (see Sim42BinaryHeader) rather than ASCII frames
+    };
+
+    /** \brief Class for a local stand in for 42 that serves synthetic telemetry and records commands.
+     *
+     *  \details The stand in listens on the loopback interface only.  Once a client connects to the
+     *  telemetry port it sends frames in 42's ASCII format, a TIME line, key = value lines, and an
+     *  [ENDMSG] line, at the configured rate to every connected client.  Each spacecraft has
+     *  SC[n].PosN, SC[n].VelN, SC[n].qn, and SC[n].wn of a circular orbit followed by SC[n].Key[k]
+     *  filler keys up to the configured key count.  Every frame also has a STANDIN.SendTimeNs key with
+     *  the steady clock time the frame was built, so a client on the same host can measure latency.
+     *  With the binary option the same fields are sent as a binary stream instead, starting with the
+     *  field table on each new connection.
+     *  Lines received on the command port are counted and, optionally, recorded with their receive time.
+     */
+    class Sim42StandIn
+    {
+    public:
+        /// @name Constructors / destructors
+        //@{
+        /// \brief Constructor taking the stand in settings.
+        /// @param  options  The settings
+        Sim42StandIn(const Sim42StandInOptions& options);
+        /// \brief Destructor.  Closes all sockets.
+        ~Sim42StandIn(void);
+        //@}
+
+        /// @name Mutators
+        //@{
+        /// \brief Serves telemetry and commands until the frame limit is reached or stop() is called.
+        /// @returns  false if a listening socket could not be opened
+        bool run(void);
+        /// \brief Makes run() return.  Safe to call from a signal handler.
+        void stop(void) {_stopped = true;}
+        //@}
+
+        /// @name Accessors
+        //@{
+        /// \brief Returns the number of frames sent
+        uint64_t get_frames_sent(void) const {return _frames_sent;}
+        /// \brief Returns the number of bytes of frames sent
+        uint64_t get_bytes_sent(void) const {return _bytes_sent;}
+        /// \brief Returns the number of commands received
+        uint64_t get_commands_received(void) const {return _commands_received;}
+        //@}
+
+    private:
+        // Disable copying and assignment
+        Sim42StandIn(const Sim42StandIn& other);
+        Sim42StandIn& operator=(const Sim42StandIn& other);
+
+        // Helper struct to handle a command client connection
+        struct CommandClient
+        {
+            int fd;
+            std::string partial;  // received text not yet ended by a new line
+        };
+
+        // Private helper methods
+        int open_listener(uint16_t port);
+        void accept_telemetry_clients(void);
+        void build_field_table(void);
+        void build_frame(uint64_t frame_number);
+        void append_field(const char *key, const double *values, int count);
+        void send_frame(void);
+        bool send_all(int fd, const std::string& data);
+        void serve_commands(void);
+        void record_command(const std::string& command);
+
+        // Private data
+        Sim42StandInOptions _options;
+        std::atomic<bool> _stopped;
+        int _telemetry_listener_fd;
+        int _command_listener_fd;
+        std::vector<int> _telemetry_clients;
+        std::vector<CommandClient> _command_clients;
+        std::ofstream _command_log;
+        std::string _frame;
+        std::string _field_table;  // the binary field table message, empty for ASCII frames
+        std::atomic<uint64_t> _frames_sent;
+        std::atomic<uint64_t> _bytes_sent;
+        std::atomic<uint64_t> _commands_received;
+    };
+}
+
+#endif
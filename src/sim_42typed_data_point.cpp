@@ -0,0 +1,59 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <sim_42data_point.hpp>
+#include <sim_42typed_data_point.hpp>
+
+namespace Nos3
+{
+
+    Sim42TypedDataPoint::Sim42TypedDataPoint(const Sim42Schema& schema, const Sim42DataPoint& dp) : _values(schema.get_value_count())
+    {
+        if (!dp.is_binary()) {
+            schema.parse(dp.get_line_views(), _values.data());
+            return;
+        }
+
+        // Elements of fields missing from the frame, or with fewer numbers than the field size, are NaN, as for text
+        std::fill(_values.begin(), _values.end(), std::numeric_limits<double>::quiet_NaN());
+        const std::deque<std::string>& keys = schema.get_keys();
+        for (std::deque<std::string>::const_iterator iter = keys.begin(); iter != keys.end(); iter++) {
+            Sim42FieldHandle handle = schema.get_handle(*iter);
+            dp.get_doubles(*iter, _values.data() + handle.offset, handle.size);
+        }
+    }
+
+    std::string Sim42TypedDataPoint::to_string(void) const
+    {
+        std::stringstream ss;
+
+        ss << std::setprecision(std::numeric_limits<double>::max_digits10);
+        ss << "42 Typed Data Point: [";
+        for (std::vector<double>::const_iterator it = _values.begin(); it != _values.end(); ++it) {
+            if (it != _values.begin()) ss << " ";
+            ss << *it;
+        }
+        ss << "]";
+        return ss.str();
+    }
+
+}
@@ -0,0 +1,131 @@
+/* Copyright (C) 2015 - 2025 National Aeronautics and Space Administration. All Foreign Rights are Reserved to the U.S. Government.
+
+   This software is provided "as is" without any warranty of any, kind either express, implied, or statutory, including, but not
+   limited to, any warranty that the software will conform to, specifications any implied warranties of merchantability, fitness
+   for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the program, or
+   any warranty that the software will be error free.
+
+   In no event shall NASA be liable for any damages, including, but not limited to direct, indirect, special or consequential damages,
+   arising out of, resulting from, or in any way connected with the software or its documentation.  Whether or not based upon warranty,
+   contract, tort or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software,
+   documentation or services provided hereunder
+
+   ITC Team
+   NASA IV&V
+   ivv-itc@lists.nasa.gov
+*/
+
+#include <cstring>
+
+#include <boost/interprocess/exceptions.hpp>
+
+#include <ItcLogger/Logger.hpp>
+
+#include <sim_data_42replay_provider.hpp>
+
+namespace Nos3
+{
+    REGISTER_DATA_PROVIDER(SimData42ReplayProvider,"42REPLAY");
+
+    extern ItcLogger::Logger *sim_logger;
+
+    namespace bip = boost::interprocess;
+
+    /*************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    SimData42ReplayProvider::SimData42ReplayProvider(const boost::property_tree::ptree& config)
+        : SimData42SocketProvider(config, true),
+          _replay_file(config.get("simulator.hardware-model.data-provider.replay-file", "42.log")),
+          _time_scale(config.get("simulator.hardware-model.data-provider.time-scale", 1.0)),
+          _loop(config.get("simulator.hardware-model.data-provider.loop", false)),
+          _replay_thread(NULL), _not_terminating(true)
+    {
+        try
+        {
+            bip::file_mapping file(_replay_file.c_str(), bip::read_only);
+            bip::mapped_region region(file, bip::read_only);
+            _file = std::move(file);
+            _region.reset(new bip::mapped_region(std::move(region))); // don't let this go out of scope/get destroyed
+        }
+        catch (const bip::interprocess_exception& e)
+        {
+            sim_logger->error("SimData42ReplayProvider::SimData42ReplayProvider:  Unable to map 42 frame log %s: %s", _replay_file.c_str(), e.what());
+            return;
+        }
+
+        const Sim42FrameLogHeader *header = static_cast<const Sim42FrameLogHeader *>(_region->get_address());
+        if ((_region->get_size() < sizeof(Sim42FrameLogHeader)) || (memcmp(header->magic, SIM42LOG_MAGIC, sizeof(header->magic)) != 0) ||
+            (header->version != SIM42LOG_VERSION))
+        {
+            sim_logger->error("SimData42ReplayProvider::SimData42ReplayProvider:  %s is not a version %u 42 frame log", _replay_file.c_str(), SIM42LOG_VERSION);
+            return;
+        }
+
+        _replay_thread = new std::thread(std::bind(&SimData42ReplayProvider::replay, this)); // Spawn thread to replay the log
+        sim_logger->info("SimData42ReplayProvider::SimData42ReplayProvider:  Replaying 42 frame log %s, %lu bytes, time scale %f%s",
+            _replay_file.c_str(), _region->get_size(), _time_scale, _loop ? ", looping" : "");
+    }
+
+    SimData42ReplayProvider::~SimData42ReplayProvider(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_replay_mutex);
+            _not_terminating = false;
+        }
+        _replay_cv.notify_all();
+        if (_replay_thread != NULL) {
+            _replay_thread->join();
+            delete _replay_thread;
+        }
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    void SimData42ReplayProvider::replay(void)
+    {
+        const char *base = static_cast<const char *>(_region->get_address());
+        const size_t size = _region->get_size();
+        const size_t first_record = static_cast<const Sim42FrameLogHeader *>(_region->get_address())->header_size;
+
+        do
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            int64_t first_receive_time_ns = 0;
+            uint64_t frames = 0;
+
+            for (size_t offset = first_record; offset + sizeof(Sim42FrameLogRecord) <= size; )
+            {
+                Sim42FrameLogRecord record;
+                memcpy(&record, base + offset, sizeof(record));
+                const char *text = base + offset + sizeof(record);
+                if ((record.length == 0) || (text + record.length > base + size)) break; // end of the recorded frames
+
+                // Pace the frame at its recorded receive time, scaled... or not at all
+                if (frames == 0) first_receive_time_ns = record.receive_time_ns;
+                std::chrono::steady_clock::time_point due = start;
+                if (_time_scale > 0.0) {
+                    due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double, std::nano>((record.receive_time_ns - first_receive_time_ns) / _time_scale));
+                }
+                if (!wait_until(due)) return;
+
+                receive_frame(boost::shared_ptr<Sim42DataPoint>(new Sim42DataPoint(text, record.length, _region, is_lazy_parsing())));
+                frames++;
+                offset += (sizeof(record) + record.length + 7) & ~(size_t)7;
+            }
+            sim_logger->info("SimData42ReplayProvider::replay:  Replayed %lu frames from %s", frames, _replay_file.c_str());
+            if (frames == 0) break; // nothing to loop over
+        } while (_loop && wait_until(std::chrono::steady_clock::now()));
+    }
+
+    bool SimData42ReplayProvider::wait_until(std::chrono::steady_clock::time_point time)
+    {
+        std::unique_lock<std::mutex> lock(_replay_mutex);
+        return !_replay_cv.wait_until(lock, time, [this]{return !_not_terminating;});
+    }
+
+}
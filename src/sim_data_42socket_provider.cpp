@@ -23,6 +23,7 @@
 
 #include <ItcLogger/Logger.hpp>
 
+#include <sim_42connection_manager.hpp>
 #include <sim_data_42socket_provider.hpp>
 
 namespace Nos3
@@ -36,25 +37,50 @@ namespace Nos3
      *************************************************************************/
 
     SimData42SocketProvider::SimData42SocketProvider(const boost::property_tree::ptree& config)
+        : SimData42SocketProvider(config, false)
+    {
+    }
+
+    SimData42SocketProvider::SimData42SocketProvider(const boost::property_tree::ptree& config, bool replaying)
         : SimIDataProvider(config),
           _server_host(config.get("simulator.hardware-model.data-provider.hostname", "localhost")),
           _server_command_port(config.get("simulator.hardware-model.data-provider.command-port", 0)), // default is no command port needed (0)... e.g. for sensor only hardware like IMUs, Star Trackers, etc.
           _max_connection_attempts(config.get("simulator.hardware-model.data-provider.max-connection-attempts", 5)),
           _retry_wait_seconds(config.get("simulator.hardware-model.data-provider.retry-wait-seconds", 5)),
-          _absolute_start_time(config.get("common.absolute-start-time", 552110400.0)), _telemetry_socket_client_thread(NULL), _not_terminating(true), _command_port_connected(false)
+          _absolute_start_time(config.get("common.absolute-start-time", 552110400.0)),
+          _lazy_parsing(config.get("simulator.hardware-model.data-provider.lazy-parsing", false)),
+          _record_file(config.get("simulator.hardware-model.data-provider.record-file", "")),
+          _pipeline(config.get("simulator.hardware-model.data-provider.telemetry-queue-depth", 8),
+              Sim42PipelineOptions::parse_overload_policy(config.get("simulator.hardware-model.data-provider.telemetry-overload-policy", "block")),
+              config.get("simulator.hardware-model.data-provider.telemetry-format", "text").compare("binary") == 0),
+          _telemetry_subscription(0),
+          _data_point(new Sim42DataPoint()), _has_data(false),
+          _key_filter(new Sim42KeyFilter(config.get_child("simulator.hardware-model.data-provider.key-filter", boost::property_tree::ptree()))),
+          _schema(config.get_child("simulator.hardware-model.data-provider.schema", boost::property_tree::ptree())),
+          _typed_data_point(new Sim42TypedDataPoint(_schema, std::vector<std::string_view>())),
+          _history_depth(config.get("simulator.hardware-model.data-provider.history-depth", 0)), _history_next(0),
+          _discrete_keys(config.get_child("simulator.hardware-model.data-provider.discrete-keys", boost::property_tree::ptree()))
     {
-        SimData42SocketProvider::connect_command_socket_as_42_socket_client();
+        _history.reserve(_history_depth);
+        if (replaying) {
+            // Nothing is sent to or recorded from a 42 that is not there
+            if (_server_command_port > 0) sim_logger->warning("SimData42SocketProvider::SimData42SocketProvider:  Replaying, ignoring COMMAND port %u", _server_command_port);
+            if (_record_file.compare("") != 0) sim_logger->warning("SimData42SocketProvider::SimData42SocketProvider:  Replaying, ignoring record-file %s", _record_file.c_str());
+            _record_file.clear();
+        } else if (_server_command_port > 0) {
+            _command_writer.reset(new Sim42CommandWriter(_server_host, _server_command_port, _max_connection_attempts, _retry_wait_seconds,
+                config.get("simulator.hardware-model.data-provider.command-queue-depth", 1024),
+                config.get("simulator.hardware-model.data-provider.command-queue-timeout-ms", 100),
+                config.get("simulator.hardware-model.data-provider.command-batch-window-us", 0)));
+            sim_logger->debug("SimData42SocketProvider::SimData42SocketProvider:  Connecting COMMAND host %s, port %u to 42 in the background.", _server_host.c_str(), _server_command_port);
+        } else sim_logger->debug("SimData42SocketProvider::SimData42SocketProvider:  No COMMAND port (%u) to 42 requested, none connected.", _server_command_port);
     }
 
     SimData42SocketProvider::~SimData42SocketProvider(void)
     {
-        _not_terminating = false;
-        if (_telemetry_socket_client_thread != NULL) {
-            _telemetry_socket_client_thread->join();
-            delete _telemetry_socket_client_thread;
+        if (_telemetry_subscription != 0) {
+            Sim42ConnectionManager::Instance().unsubscribe(_telemetry_subscription); // no more frames are received once this returns
         }
-        close(_telemetry_socket_fd); // close the socket
-        close(_command_socket_fd); // close the socket
     }
 
     /*************************************************************************
@@ -63,34 +89,66 @@ namespace Nos3
 
      void SimData42SocketProvider::send_command_to_socket(const std::string& message)
      {
-        if (_command_port_connected) {
-            ssize_t bytes_sent = send(_command_socket_fd, message.c_str(), message.length(), 0);
-            if (bytes_sent == (ssize_t)message.length()) {
-                sim_logger->debug("SimData42SocketProvider::send_command_to_socket:  Successfully sent command to host %s, port %u.  Command %s", _server_host.c_str(), _server_command_port, message.c_str());
-            } else {
-                sim_logger->error("SimData42SocketProvider::send_command_to_socket:  Unsuccessful sending command to host %s, port %u.  Bytes to send %lu, bytes sent/return value %lu.  Command %s",
-                    _server_host.c_str(), _server_command_port, message.length(), bytes_sent, message.c_str());
-            }
+        if (_command_writer) {
+            _command_writer->send(message); // the writer logs any command it drops
         } else {
-            sim_logger->error("SimData42SocketProvider::send_command_to_socket:  Not connected.  Not sending command to host %s, port %u.  Command %s", _server_host.c_str(), _server_command_port, message.c_str());
+            sim_logger->error("SimData42SocketProvider::send_command_to_socket:  No COMMAND port.  Not sending command to host %s.  Command %s", _server_host.c_str(), message.c_str());
         }
      }
 
+    Sim42PipelineStats SimData42SocketProvider::get_telemetry_stats(void) const
+    {
+        if (_telemetry_subscription == 0) return Sim42PipelineStats();
+        return Sim42ConnectionManager::Instance().get_pipeline_stats(_telemetry_subscription);
+    }
+
+    boost::shared_ptr<SimIDataPoint> SimData42SocketProvider::get_data_point_at(double abs_time) const
+    {
+        HistoryEntry before, after;
+        {
+            std::lock_guard<std::mutex> lock(_history_mutex);
+            size_t count = _history.size();
+            if (count == 0) return get_data_point();
+
+            size_t oldest = (count < _history_depth) ? 0 : _history_next;
+            before = _history[oldest];
+            after = _history[(oldest + count - 1) % count];
+            if (abs_time <= before.abs_time) return before.data_point;
+            if (abs_time >= after.abs_time) return after.data_point;
+
+            // Walk from the oldest frame to the first frame at or after the requested time
+            for (size_t i = 1; i < count; i++) {
+                const HistoryEntry& entry = _history[(oldest + i) % count];
+                if (entry.abs_time >= abs_time) {
+                    after = entry;
+                    break;
+                }
+                before = entry;
+            }
+            // Lock is released when scope ends
+        }
+        return boost::shared_ptr<SimIDataPoint>(new Sim42DataPoint(Sim42DataPoint::interpolate(*before.data_point, *after.data_point, abs_time, &_discrete_keys)));
+    }
+
     /*************************************************************************
      * Protected mutating worker methods
      *************************************************************************/
 
     void SimData42SocketProvider::connect_reader_thread_as_42_socket_client(std::string server_host, uint16_t server_telemetry_port)
     {
-        bool connected = connect_as_42_socket_client(server_host, server_telemetry_port, _telemetry_socket_fd);
-        if (connected) {
-            _telemetry_socket_client_thread = new std::thread(std::bind(&SimData42SocketProvider::telemetry_socket_reader, this), NULL); // Spawn thread to listen to/read from socket
-            sim_logger->debug("SimData42SocketProvider::connect_reader_thread_as_42_socket_client:  Successfully connected TELEMETRY host %s, port %u to 42 and started listener thread!",
-                server_host.c_str(), server_telemetry_port);
-        } else {
-            sim_logger->error("SimData42SocketProvider::connect_reader_thread_as_42_socket_client:  Unable to connect TELEMETRY host %s, port %u to 42, no thread will be started to listen :-(",
-                server_host.c_str(), server_telemetry_port);
+        // The schema is complete now... size the "no data yet" typed data point to match it
+        boost::atomic_store(&_typed_data_point, boost::shared_ptr<Sim42TypedDataPoint>(new Sim42TypedDataPoint(_schema, std::vector<std::string_view>())));
+
+        // ... and make sure a key filter keeps the schema fields
+        if (!_key_filter->empty()) {
+            const std::deque<std::string>& keys = _schema.get_keys();
+            for (std::deque<std::string>::const_iterator iter = keys.begin(); iter != keys.end(); iter++) _key_filter->add_pattern(*iter);
         }
+
+        _telemetry_subscription = Sim42ConnectionManager::Instance().subscribe(server_host, server_telemetry_port, _max_connection_attempts,
+            _retry_wait_seconds, std::bind(&SimData42SocketProvider::receive_frame, this, std::placeholders::_1), _lazy_parsing, _key_filter, _pipeline, _record_file);
+        sim_logger->debug("SimData42SocketProvider::connect_reader_thread_as_42_socket_client:  Subscribed to TELEMETRY host %s, port %u from 42, data arrives once it connects.",
+            server_host.c_str(), server_telemetry_port);
         return;
     }
 
@@ -98,135 +156,38 @@ namespace Nos3
      * Private helper methods
      *************************************************************************/
 
-    void SimData42SocketProvider::connect_command_socket_as_42_socket_client(void)
-    {
-        if (_server_command_port > 0) {
-            _command_port_connected = connect_as_42_socket_client(_server_host, _server_command_port, _command_socket_fd);
-            if (_command_port_connected) sim_logger->debug("SimData42SocketProvider::SimData42SocketProvider:  Successfully connected COMMAND host %s, port %u to 42!", _server_host.c_str(), _server_command_port);
-            else sim_logger->error("SimData42SocketProvider::SimData42SocketProvider:  Unable to connect COMMAND host %s, port %u to 42 :-(", _server_host.c_str(), _server_command_port);
-        } else sim_logger->debug("SimData42SocketProvider::SimData42SocketProvider:  No COMMAND port (%u) to 42 requested, none connected.", _server_command_port);
-    }
-
-    bool SimData42SocketProvider::connect_as_42_socket_client(std::string a_42_host, uint16_t a_42_port, int &socket_fd)
+    void SimData42SocketProvider::receive_frame(const boost::shared_ptr<Sim42DataPoint>& dp)
     {
-        // http://stackoverflow.com/questions/8257714/how-to-convert-an-int-to-string-in-c/8257728#8257728
-        int length = (int)((ceil(log10(a_42_port))+1)*sizeof(char));
-        char a_42_port_string[length];
-        snprintf(a_42_port_string, length, "%ud", a_42_port);
-
-        // http://beej.us/guide/bgnet/output/html/singlepage/bgnet.html
-        struct addrinfo hints, *servinfo, *p;
-        int rv;
-
-        memset(&hints, 0, sizeof hints);
-        hints.ai_family = AF_UNSPEC;
-        hints.ai_socktype = SOCK_STREAM;
-
-        for (int i = 0; i < _max_connection_attempts + 1; i++)
-        {
-            if ((rv = getaddrinfo(a_42_host.c_str(), a_42_port_string, &hints, &servinfo)) != 0)
-            {
-                sim_logger->error("SimData42SocketProvider::connect_as_42_socket_client:  Error getting address for host %s, port %u: %s", a_42_host.c_str(), a_42_port, gai_strerror(rv));
-                return false;
-            }
-
-            // loop through all the results and connect to the first we can
-            for(p = servinfo; p != NULL; p = p->ai_next)
-            {
-                if ((socket_fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) == -1)
-                {
-                    sim_logger->warning("SimData42SocketProvider::connect_as_42_socket_client:  Continuing, but could not create socket for host %s, port %u: %s", a_42_host.c_str(), a_42_port, strerror(errno));
-                    continue;
-                }
-                if (connect(socket_fd, p->ai_addr, p->ai_addrlen) == -1)
-                {
-                    close(socket_fd);
-                    sim_logger->warning("SimData42SocketProvider::connect_as_42_socket_client:  Continuing, but could not connect socket for host %s, port %u: %s", a_42_host.c_str(), a_42_port, strerror(errno));
-                    continue;
-                } else break; // got a good connection
-            }
-
-            if (p != NULL) // got a good connection
-            {
-                break;
-            } else
-            {
-                if (i == _max_connection_attempts)
-                {
-                    sim_logger->error("SimData42SocketProvider::connect_as_42_socket_client:  Maximum number of connection attempts reached.   Host %s, port %u failed to connect!", a_42_host.c_str(), a_42_port);
-                    return false;
-                }
-                else
-                {
-                    sim_logger->warning("SimData42SocketProvider::connect_as_42_socket_client:  Warning... failed to connect host %s, port %d... retrying in %u seconds.", a_42_host.c_str(), a_42_port,
-                                        _retry_wait_seconds);
-                    sleep(_retry_wait_seconds);
-                }
-            }
-        }
-        return true; // connection succeeded... may have taken a while, but it succeeded
-    }
-
-    void SimData42SocketProvider::telemetry_socket_reader(void)
-    {
-        std::vector<std::string> message;
-
-        while (_not_terminating)
-        {
-            read_telemetry_socket_data(message);
-
-            {
-                std::lock_guard<std::mutex> lock(_data_point_mutex);
-                Sim42DataPoint dp(message);
-                _data_point = dp;
-                // Lock is released when scope ends
-            }
-
-            //sim_logger->debug("SimData42SocketProvider::socket_reader:  Data Point=%s\n", _data_point.to_formatted_string().c_str());
+        if (!_schema.empty()) {
+            boost::atomic_store(&_typed_data_point, boost::shared_ptr<Sim42TypedDataPoint>(new Sim42TypedDataPoint(_schema, *dp)));
         }
+        boost::atomic_store(&_data_point, dp);
+        _has_data = true;
+        if (_history_depth > 0) add_to_history(dp);
+        notify_subscribers(dp);
     }
 
-    void SimData42SocketProvider::read_telemetry_socket_data(std::vector<std::string>& message)
+    void SimData42SocketProvider::add_to_history(const boost::shared_ptr<Sim42DataPoint>& dp)
     {
-        long Done = 0;
-        char line[512] = "Blank";
-        char *LineIsValid;
+        if (!dp->has_time()) return; // no TIME line, cannot index this frame
 
-        message.clear();
-        while(!Done)
+        HistoryEntry entry;
+        entry.abs_time = dp->get_abs_time();
+        entry.data_point = dp;
         {
-            LineIsValid = rgets(line, 511, _telemetry_socket_fd);
-            sim_logger->trace("SimData42SocketProvider::read_socket_data:  Line=%s", line);
-            if (LineIsValid == NULL)
-            {
-                Done = 1;
-            } else {
-                message.push_back(line);
-                if (!strncmp(line,"[ENDMSG]",8)) Done = 1;
+            std::lock_guard<std::mutex> lock(_history_mutex);
+            size_t count = _history.size();
+            if ((count > 0) && (entry.abs_time < _history[(_history_next + _history_depth - 1) % _history_depth].abs_time)) {
+                // 42 time went backwards (e.g. 42 restarted)... the old history no longer brackets anything
+                sim_logger->info("SimData42SocketProvider::add_to_history:  ABSTIME %f is before the newest frame, clearing history", entry.abs_time);
+                _history.clear();
+                _history_next = 0;
             }
+            if (_history.size() < _history_depth) _history.push_back(entry);
+            else _history[_history_next] = entry;
+            _history_next = (_history_next + 1) % _history_depth;
+            // Lock is released when scope ends
         }
     }
 
-    char SimData42SocketProvider::rgetc(int fd)
-    {
-        char buf;
-        if (read(fd, &buf, 1) != 1)
-            return EOF;
-        return buf;
-    }
-
-    char* SimData42SocketProvider::rgets(char *s, int n, int fd) /* K&R, 2nd, p. 165 */
-    {
-        register int c;
-        register char *cs;
-
-        cs = s;
-        while (--n > 0 && (c = rgetc(fd)) != EOF) // ssize_t read(int fd, void *buf, size_t count);
-            if ((*cs++ = c) == '\n')
-                break;
-        *cs = '\0';
-        if (cs != s) *(cs-1) = '\0'; // Hack off the \n
-        return (c == EOF && cs == s) ? NULL : s;
-    }
-
 }
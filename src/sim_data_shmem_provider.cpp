@@ -15,6 +15,20 @@
    ivv-itc@lists.nasa.gov
 */
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+
 #include <sim_data_shmem_provider.hpp>
 
 #include <ItcLogger/Logger.hpp>
@@ -25,17 +39,203 @@ namespace Nos3
 
     extern ItcLogger::Logger *sim_logger;
 
+    namespace
+    {
+        // How long the watcher blocks waiting for a writer that uses the seqlock before checking whether to stop; publishes wake it sooner.
+        // The destructor does not wake it, since a wake on the shared sequence would reach the waiters of every process.
+        const std::chrono::microseconds SEQLOCK_WRITER_WAIT(100000);
+    }
+
     /*************************************************************************
      * Constructors / Destructors
      *************************************************************************/
-    SimDataShmemProvider::SimDataShmemProvider(const boost::property_tree::ptree& config) : SimIDataProvider(config)
+    SimDataShmemProvider::SimDataShmemProvider(const boost::property_tree::ptree& config) : SimIDataProvider(config),
+        _huge_pages(config.get("simulator.hardware-model.shared-memory-huge-pages", "none")),
+        _hugetlbfs_dir(config.get("simulator.hardware-model.shared-memory-hugetlbfs-dir", "/dev/hugepages")),
+        _lock_memory(config.get("simulator.hardware-model.shared-memory-lock", false)),
+        _prefault(config.get("simulator.hardware-model.shared-memory-prefault", false)), _history(NULL), _history_depth(0), _actuators(NULL),
+        _poll_interval(config.get("simulator.hardware-model.shared-memory-poll-us", 1000)), _watcher_thread(NULL), _watcher_terminating(false)
     {
+        if (_huge_pages != "none" && _huge_pages != "transparent" && _huge_pages != "hugetlbfs") {
+            sim_logger->warning("SimDataShmemProvider::SimDataShmemProvider:  Unknown huge pages option %s, using none", _huge_pages.c_str());
+            _huge_pages = "none";
+        }
         const std::string shm_name = config.get("simulator.hardware-model.shared-memory-name", "Blackboard");
-        const size_t shm_size = sizeof(BlackboardData);
-        bip::shared_memory_object shm(bip::open_or_create, shm_name.c_str(), bip::read_write);
-        shm.truncate(shm_size);
-        bip::mapped_region shm_region(shm, bip::read_write);
-        _shm_region = std::move(shm_region); // don't let this go out of scope/get destroyed
-        _blackboard_data = static_cast<BlackboardData*>(_shm_region.get_address());    
+        const uint32_t slot_count = config.get("simulator.hardware-model.shared-memory-slots", 0u);
+        const uint32_t slot = config.get("simulator.hardware-model.shared-memory-slot", 0u);
+        const uint32_t history_depth = config.get("simulator.hardware-model.shared-memory-history", 0u);
+        if ((slot_count == 0 && slot != 0) || (slot_count > 0 && slot >= slot_count)) {
+            sim_logger->error("SimDataShmemProvider::SimDataShmemProvider:  Slot %u is not one of the %u slots of %s", slot, slot_count, shm_name.c_str());
+            throw std::runtime_error("SimDataShmemProvider::SimDataShmemProvider:  Shared memory slot out of range");
+        }
+        if (slot_count == 0 && history_depth != 0) {
+            sim_logger->error("SimDataShmemProvider::SimDataShmemProvider:  A history needs the shared-memory-slots layout of %s", shm_name.c_str());
+            throw std::runtime_error("SimDataShmemProvider::SimDataShmemProvider:  Shared memory history without slots");
+        }
+        uint32_t fields = 0;
+        std::istringstream field_names(config.get("simulator.hardware-model.shared-memory-fields", ""));
+        for (std::string name; field_names >> name; ) {
+            BlackboardField field = blackboard_field_from_name(name.c_str());
+            if (field == BLACKBOARD_FIELD_COUNT) {
+                sim_logger->error("SimDataShmemProvider::SimDataShmemProvider:  %s is not a blackboard field", name.c_str());
+                throw std::runtime_error("SimDataShmemProvider::SimDataShmemProvider:  Unknown shared memory field");
+            }
+            fields |= blackboard_field_bit(field);
+        }
+        blackboard_resolve_mask(fields == 0 ? blackboard_all_fields() : fields, _field_mask);
+
+        _shm_region = map_segment(shm_name, blackboard_segment_size(slot_count, history_depth)); // don't let this go out of scope/get destroyed
+        if (slot_count == 0) {
+            _blackboard = static_cast<BlackboardSlot*>(_shm_region.get_address());
+        } else {
+            BlackboardSegmentHeader *header = static_cast<BlackboardSegmentHeader*>(_shm_region.get_address());
+            if (!blackboard_attach(header, slot_count, history_depth)) {
+                sim_logger->error("SimDataShmemProvider::SimDataShmemProvider:  %s has version %u, %u slots of %u bytes, history %u, "
+                    "expected version %u, %u slots of %u bytes, history %u", shm_name.c_str(), header->version, header->slot_count, header->slot_size,
+                    header->history_depth, BLACKBOARD_VERSION, slot_count, (uint32_t)sizeof(BlackboardSlot), history_depth);
+                throw std::runtime_error("SimDataShmemProvider::SimDataShmemProvider:  Incompatible shared memory segment");
+            }
+            _blackboard = blackboard_slot(header, slot);
+            _history = blackboard_history(header, slot);
+            _history_depth = header->history_depth;
+        }
+        sim_logger->debug("SimDataShmemProvider::SimDataShmemProvider:  Reading slot %u of %u of %s", slot, slot_count, shm_name.c_str());
+
+        const std::string actuator_name = config.get("simulator.hardware-model.actuator-memory-name", "");
+        if (!actuator_name.empty()) {
+            const uint32_t actuator_slot_count = std::max(slot_count, 1u); // the original layout is one spacecraft
+            _actuator_region = map_segment(actuator_name, actuator_segment_size(actuator_slot_count));
+            ActuatorSegmentHeader *header = static_cast<ActuatorSegmentHeader*>(_actuator_region.get_address());
+            if (!actuator_attach(header, actuator_slot_count)) {
+                sim_logger->error("SimDataShmemProvider::SimDataShmemProvider:  %s has version %u, %u slots of %u bytes, expected version %u, %u slots of %u bytes",
+                    actuator_name.c_str(), header->version, header->slot_count, header->slot_size, ACTUATOR_VERSION, actuator_slot_count, (uint32_t)sizeof(ActuatorSlot));
+                throw std::runtime_error("SimDataShmemProvider::SimDataShmemProvider:  Incompatible actuator shared memory segment");
+            }
+            _actuators = actuator_slot(header, slot);
+            sim_logger->debug("SimDataShmemProvider::SimDataShmemProvider:  Writing actuator slot %u of %s", slot, actuator_name.c_str());
+        }
+    }
+
+    SimDataShmemProvider::~SimDataShmemProvider(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_watcher_mutex);
+            _watcher_terminating = true;
+        }
+        if (_watcher_thread != NULL) {
+            _watcher_thread->join(); // within SEQLOCK_WRITER_WAIT or the poll interval
+            delete _watcher_thread;
+        }
+    }
+
+    /*************************************************************************
+     * Mutating public worker methods
+     *************************************************************************/
+
+    bool SimDataShmemProvider::send_actuator_command(ActuatorType type, uint32_t index, double abs_time, double command)
+    {
+        if (_actuators == NULL) {
+            sim_logger->error("SimDataShmemProvider::send_actuator_command:  No actuator-memory-name.  Not sending command %f to actuator %d[%u]", command, (int)type, index);
+            return false;
+        }
+        ActuatorChannel *channel = actuator_channel(*_actuators, type, index);
+        if (channel == NULL) {
+            sim_logger->error("SimDataShmemProvider::send_actuator_command:  No actuator %d[%u].  Not sending command %f", (int)type, index, command);
+            return false;
+        }
+        ActuatorCommand actuator_command = {abs_time, command};
+        actuator_write(*_actuators, *channel, actuator_command);
+        return true;
+    }
+
+    /*************************************************************************
+     * Protected subscription methods
+     *************************************************************************/
+
+    void SimDataShmemProvider::start_notifications(void)
+    {
+        _watcher_thread = new std::thread(std::bind(&SimDataShmemProvider::watch_blackboard, this)); // Spawn thread to watch for new data
+        sim_logger->debug("SimDataShmemProvider::start_notifications:  Watching the blackboard for new data every %ld microseconds", (long)_poll_interval.count());
+    }
+
+    /*************************************************************************
+     * Private helper methods
+     *************************************************************************/
+
+    void SimDataShmemProvider::watch_blackboard(void)
+    {
+        const volatile double *abs_time = &_blackboard->data.AbsTime; // written by another process
+        double last_abs_time = *abs_time;
+        uint32_t last_sequence = _blackboard->sequence.load(std::memory_order_acquire);
+        bool seqlock_writer = false; // once the writer uses the seqlock, publishes wake the watcher and AbsTime need not be polled
+        std::unique_lock<std::mutex> lock(_watcher_mutex);
+        while (!_watcher_terminating)
+        {
+            lock.unlock();
+            bool published = blackboard_wait(*_blackboard, last_sequence, seqlock_writer ? SEQLOCK_WRITER_WAIT : _poll_interval);
+            bool changed = published || *abs_time != last_abs_time;
+            if (changed) {
+                seqlock_writer = seqlock_writer || published;
+                boost::shared_ptr<SimShmemDataPoint> dp(new SimShmemDataPoint());
+                last_sequence = blackboard_read(*_blackboard, _field_mask, dp->get_data());
+                last_abs_time = dp->get_AbsTime();
+                notify_subscribers(dp);
+            }
+            lock.lock();
+        }
+    }
+
+    bip::mapped_region SimDataShmemProvider::map_segment(const std::string& name, size_t size) const
+    {
+        bip::mapped_region region;
+        if (_huge_pages == "hugetlbfs") {
+            // memfd huge pages cannot be opened by name from another process, so the segment is a file on a hugetlbfs mount
+            const std::string path = _hugetlbfs_dir + "/" + name;
+            int fd = open(path.c_str(), O_CREAT | O_RDWR, 0666);
+            struct statfs fs;
+            struct stat st;
+            if (fd < 0 || fstatfs(fd, &fs) != 0 || fstat(fd, &st) != 0) {
+                sim_logger->error("SimDataShmemProvider::map_segment:  Unable to open %s:  %s", path.c_str(), strerror(errno));
+                if (fd >= 0) close(fd);
+                throw std::runtime_error("SimDataShmemProvider::map_segment:  Unable to open huge page segment");
+            }
+            size = (size + fs.f_bsize - 1)/fs.f_bsize*fs.f_bsize; // hugetlbfs files are whole huge pages
+            if (st.st_size < (off_t)size && ftruncate(fd, size) != 0) { // never shrink another simulator's segment
+                sim_logger->error("SimDataShmemProvider::map_segment:  Unable to size %s to %lu bytes:  %s", path.c_str(), (unsigned long)size, strerror(errno));
+                close(fd);
+                throw std::runtime_error("SimDataShmemProvider::map_segment:  Unable to size huge page segment");
+            }
+            close(fd);
+            bip::file_mapping file(path.c_str(), bip::read_write);
+            region = bip::mapped_region(file, bip::read_write);
+        } else {
+            bip::shared_memory_object shm(bip::open_or_create, name.c_str(), bip::read_write);
+            bip::offset_t existing_size = 0;
+            if (!shm.get_size(existing_size) || existing_size < (bip::offset_t)size) shm.truncate(size); // never shrink another simulator's segment
+            region = bip::mapped_region(shm, bip::read_write);
+#ifdef MADV_HUGEPAGE
+            if (_huge_pages == "transparent" && madvise(region.get_address(), region.get_size(), MADV_HUGEPAGE) != 0) {
+                sim_logger->warning("SimDataShmemProvider::map_segment:  No transparent huge pages for %s:  %s", name.c_str(), strerror(errno));
+            }
+#endif
+        }
+        if (_lock_memory && mlock(region.get_address(), region.get_size()) != 0) {
+            sim_logger->warning("SimDataShmemProvider::map_segment:  Unable to lock %s in memory (see ulimit -l):  %s", name.c_str(), strerror(errno));
+        }
+        if (_prefault) prefault(region);
+        sim_logger->debug("SimDataShmemProvider::map_segment:  Mapped %lu bytes of %s, huge pages %s%s%s", (unsigned long)region.get_size(), name.c_str(),
+            _huge_pages.c_str(), _lock_memory ? ", locked" : "", _prefault ? ", prefaulted" : "");
+        return region;
+    }
+
+    void SimDataShmemProvider::prefault(const bip::mapped_region& region) const
+    {
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(region.get_address(), region.get_size(), MADV_POPULATE_WRITE) == 0) return;
+#endif
+        // Reading each page faults it in without writing over data another process may be publishing
+        const size_t page_size = bip::mapped_region::get_page_size();
+        const volatile char *address = static_cast<const volatile char *>(region.get_address());
+        for (size_t offset = 0; offset < region.get_size(); offset += page_size) (void)address[offset];
     }
 }